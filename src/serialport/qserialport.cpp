@@ -10,7 +10,15 @@
 
 #include "qserialport_p.h"
 
+#include <QtCore/qchronotimer.h>
 #include <QtCore/qdebug.h>
+#include <QtCore/qdeadlinetimer.h>
+#include <QtCore/qmetaobject.h>
+#include <QtCore/qthread.h>
+#include <QtCore/qvarlengtharray.h>
+
+#include <cstring>
+#include <utility>
 
 QT_BEGIN_NAMESPACE
 
@@ -69,6 +77,647 @@ void QSerialPortPrivate::setError(const QSerialPortErrorInfo &errorInfo)
     emit q->errorOccurred(error);
 }
 
+qint64 QSerialPortPrivate::nextReadChunkSize() const
+{
+    return adaptiveReadChunkSize ? currentReadChunkSize : readBufferChunkSize;
+}
+
+void QSerialPortPrivate::updateReadChunkSize(qint64 requestedSize, qint64 readBytes)
+{
+    // Number of consecutive short reads after which the chunk is shrunk.
+    static constexpr int ShortReadsBeforeShrink = 8;
+
+    if (!adaptiveReadChunkSize || requestedSize < currentReadChunkSize)
+        return;
+
+    if (readBytes >= requestedSize) {
+        // The chunk was filled completely, so more data is probably
+        // pending in the driver. Grow to reduce the number of syscalls.
+        currentReadChunkSize = qMin(currentReadChunkSize * 2, qint64(readBufferChunkSize));
+        shortReadCount = 0;
+    } else if (readBytes < currentReadChunkSize / 4) {
+        if (++shortReadCount >= ShortReadsBeforeShrink) {
+            currentReadChunkSize = qMax(currentReadChunkSize / 2,
+                                        qint64(QSERIALPORT_MIN_READ_CHUNKSIZE));
+            shortReadCount = 0;
+        }
+    } else {
+        shortReadCount = 0;
+    }
+}
+
+void QSerialPortPrivate::processReceivedData(qint64 bytes)
+{
+    receivedBytesTotal += bytes;
+
+    const bool newFrames = (frameDecoder || !frameDelimiter.isEmpty()) && scanForFrames();
+
+    // The frames are known at this point, so they can be discarded whole.
+    if (isDiscardingOldestData() && buffer.size() > readBufferMaxSize)
+        discardOldestData(buffer.size() - readBufferMaxSize);
+
+    unreportedReadBytes += bytes;
+    updateReadBufferWatermarks();
+    emitReadyRead();
+    if (newFrames)
+        emitFrameReady();
+}
+
+void QSerialPortPrivate::emitReadyRead()
+{
+    Q_Q(QSerialPort);
+
+    // Only the data received since the last readyRead() counts, as the
+    // application may leave some data in the buffer. Discarded data does
+    // not count either.
+    const qint64 newBytes = qMin(unreportedReadBytes, buffer.size());
+    const bool coalescing = readyReadThreshold > 0 || readyReadLatency.count() > 0;
+    if (coalescing && (readyReadThreshold <= 0 || newBytes < readyReadThreshold)) {
+        // Wait for more data, but no longer than the latency budget
+        // allows for the oldest byte not yet reported.
+        if (readyReadLatency.count() > 0) {
+            if (!readyReadTimer) {
+                readyReadTimer = new QChronoTimer(q);
+                readyReadTimer->setSingleShot(true);
+                readyReadTimer->setTimerType(Qt::PreciseTimer);
+                QObjectPrivate::connect(readyReadTimer, &QChronoTimer::timeout,
+                                        this, &QSerialPortPrivate::flushReadyRead);
+            }
+            if (!readyReadTimer->isActive()) {
+                readyReadTimer->setInterval(readyReadLatency);
+                readyReadTimer->start();
+            }
+        }
+        return;
+    }
+
+    flushReadyRead();
+}
+
+void QSerialPortPrivate::flushReadyRead()
+{
+    Q_Q(QSerialPort);
+
+    if (readyReadTimer)
+        readyReadTimer->stop();
+
+    // only emit readyRead() if there is data available
+    if (buffer.isEmpty()) {
+        unreportedReadBytes = 0;
+        return;
+    }
+
+#if defined(Q_OS_UNIX)
+    // only emit readyRead() when not recursing; the Windows backend has
+    // always emitted it for every completed read
+    if (emittedReadyRead)
+        return;
+#endif
+
+    unreportedReadBytes = 0;
+    emittedReadyRead = true;
+    emit q->readyRead();
+    emittedReadyRead = false;
+
+    scheduleReadBufferWatermarkCheck();
+}
+
+void QSerialPortPrivate::coalesceWrite()
+{
+    Q_Q(QSerialPort);
+
+    if (writeBuffer.isEmpty())
+        return;
+    ++queuedWriteCount;
+
+    if (writeCoalescingDelay.count() > 0
+            && (writeCoalescingSize <= 0 || writeBuffer.size() < writeCoalescingSize)) {
+        // Hold the data back for more writes, but no longer than the
+        // window allows for the oldest byte not yet submitted.
+        if (!writeCoalescingTimer) {
+            writeCoalescingTimer = new QChronoTimer(q);
+            writeCoalescingTimer->setSingleShot(true);
+            writeCoalescingTimer->setTimerType(Qt::PreciseTimer);
+            QObjectPrivate::connect(writeCoalescingTimer, &QChronoTimer::timeout,
+                                    this, &QSerialPortPrivate::flushCoalescedWrite);
+        }
+        if (!writeCoalescingTimer->isActive()) {
+            writeCoalescingTimer->setInterval(writeCoalescingDelay);
+            writeCoalescingTimer->start();
+        }
+        return;
+    }
+
+    flushCoalescedWrite();
+}
+
+void QSerialPortPrivate::flushCoalescedWrite()
+{
+    if (writeCoalescingTimer)
+        writeCoalescingTimer->stop();
+
+    scheduleAsyncWrite();
+}
+
+void QSerialPortPrivate::recordWriteSubmission()
+{
+    // All the writes queued since the previous submission but the first
+    // one went to the driver without a write operation of their own.
+    coalescedWrites += qMax(queuedWriteCount - 1, qint64(0));
+    queuedWriteCount = 0;
+}
+
+bool QSerialPortPrivate::hasPendingWriteData() const
+{
+    return !writeBuffer.isEmpty() || !urgentWriteBuffer.isEmpty();
+}
+
+qint64 QSerialPortPrivate::pendingWriteUnitSize() const
+{
+    // Only the rest of a write which has been partially submitted
+    // has to go out before urgent data.
+    if (writeUnitEnds.isEmpty() || writeUnitStart >= submittedNormalBytes)
+        return 0;
+    return writeUnitEnds.constFirst() - submittedNormalBytes;
+}
+
+bool QSerialPortPrivate::isUrgentWriteDue() const
+{
+    return !urgentWriteBuffer.isEmpty() && pendingWriteUnitSize() == 0;
+}
+
+void QSerialPortPrivate::recordWriteUnit()
+{
+    writeUnitEnds.append(submittedNormalBytes + writeBuffer.size());
+    advanceNormalWriteLane(0);
+}
+
+void QSerialPortPrivate::advanceNormalWriteLane(qint64 bytes)
+{
+    submittedNormalBytes += bytes;
+    while (!writeUnitEnds.isEmpty() && writeUnitEnds.constFirst() <= submittedNormalBytes)
+        writeUnitStart = writeUnitEnds.takeFirst();
+    while (!addressOffsets.isEmpty() && addressOffsets.constFirst() < submittedNormalBytes)
+        addressOffsets.removeFirst();
+}
+
+// Drops the bytes accepted by the driver from the lanes they were
+// taken from, in the same order.
+void QSerialPortPrivate::consumeWriteLanes(qint64 bytes)
+{
+    if (isUrgentWriteDue()) {
+        const qint64 urgentBytes = qMin(bytes, urgentWriteBuffer.size());
+        urgentWriteBuffer.free(urgentBytes);
+        submittedUrgentBytes += urgentBytes;
+        bytes -= urgentBytes;
+    }
+    writeBuffer.free(bytes);
+    advanceNormalWriteLane(bytes);
+}
+
+void QSerialPortPrivate::clearWriteLanes()
+{
+    writeBuffer.clear();
+    urgentWriteBuffer.clear();
+    writeUnitEnds.clear();
+    writeUnitStart = submittedNormalBytes;
+    addressOffsets.clear();
+}
+
+// Returns the time the given number of characters takes on the wire,
+// with the current settings, but at least the time of one character.
+std::chrono::microseconds QSerialPortPrivate::transmitTime(qint64 bytes) const
+{
+    const qint64 bitsPerCharacter = 1 + dataBits.valueBypassingBindings()
+            + (parity.valueBypassingBindings() == QSerialPort::NoParity ? 0 : 1)
+            + (stopBits.valueBypassingBindings() == QSerialPort::OneStop ? 1 : 2);
+    const qint64 baudRate = outputBaudRate > 0 ? outputBaudRate : QSerialPort::Baud9600;
+    return std::chrono::microseconds(qMax(bytes, qint64(1)) * bitsPerCharacter * 1000000
+                                     / baudRate);
+}
+
+bool QSerialPortPrivate::isWriteInProgress() const
+{
+#if defined(Q_OS_WIN32)
+    return hasPendingWriteData() || writeStarted;
+#else
+    return hasPendingWriteData() || writeSequenceStarted
+            || (ioThread && ioThread->bytesToWrite() > 0);
+#endif
+}
+
+void QSerialPortPrivate::scheduleTransmitCompleteCheck()
+{
+    Q_Q(QSerialPort);
+
+    // Polling the driver is only worth it if someone is interested.
+    static const QMetaMethod transmitCompleteSignal =
+            QMetaMethod::fromSignal(&QSerialPort::transmitComplete);
+    if (!q->isSignalConnected(transmitCompleteSignal))
+        return;
+
+    if (!transmitCompleteTimer) {
+        transmitCompleteTimer = new QChronoTimer(q);
+        transmitCompleteTimer->setSingleShot(true);
+        transmitCompleteTimer->setTimerType(Qt::PreciseTimer);
+        QObjectPrivate::connect(transmitCompleteTimer, &QChronoTimer::timeout,
+                                this, &QSerialPortPrivate::checkTransmitComplete);
+    }
+    if (!transmitCompleteTimer->isActive()) {
+        transmitCompleteTimer->setInterval(std::chrono::nanoseconds::zero());
+        transmitCompleteTimer->start();
+    }
+}
+
+void QSerialPortPrivate::checkTransmitComplete()
+{
+    Q_Q(QSerialPort);
+
+    // The check is scheduled again once the new data has been written.
+    if (isWriteInProgress())
+        return;
+
+    const qint64 queuedBytes = transmitterQueueSize();
+    if (queuedBytes < 0)
+        return;
+
+    if (queuedBytes > 0) {
+        // Check again when the queued data should have left the wire.
+        transmitCompleteTimer->setInterval(transmitTime(queuedBytes));
+        transmitCompleteTimer->start();
+        return;
+    }
+
+    emit q->transmitComplete();
+}
+
+bool QSerialPortPrivate::waitForTransmitComplete(int msecs)
+{
+    Q_Q(QSerialPort);
+
+    const QDeadlineTimer deadline(msecs);
+
+    while (isWriteInProgress()) {
+        if (!waitForBytesWritten(int(deadline.remainingTime())))
+            return false;
+    }
+
+    for (;;) {
+        const qint64 queuedBytes = transmitterQueueSize();
+        if (queuedBytes < 0) {
+            setError(getSystemError());
+            return false;
+        }
+        if (queuedBytes == 0)
+            break;
+        if (deadline.hasExpired()) {
+            setError(QSerialPortErrorInfo(QSerialPort::TimeoutError));
+            return false;
+        }
+        QThread::sleep(qMin(std::chrono::nanoseconds(transmitTime(queuedBytes)),
+                            deadline.remainingTimeAsDuration()));
+    }
+
+    if (transmitCompleteTimer)
+        transmitCompleteTimer->stop();
+    emit q->transmitComplete();
+    return true;
+}
+
+template <typename Buffer>
+qint64 QSerialPortPrivate::appendFrame(Buffer &buffer, QByteArrayView payload)
+{
+    qint64 encodedSize = payload.size() + frameDelimiter.size();
+
+    if (frameEncoder) {
+        // Encode right into the write buffer, and give back what the
+        // worst case estimation reserved in excess.
+        const qint64 maximumSize = frameEncoder->maximumEncodedSize(payload.size());
+        char *ptr = buffer.reserve(maximumSize);
+        encodedSize = frameEncoder->encode(payload.data(), payload.size(), ptr);
+        buffer.chop(maximumSize - qMax(encodedSize, qint64(0)));
+        if (encodedSize < 0) {
+            setError(QSerialPortErrorInfo(QSerialPort::UnsupportedOperationError,
+                                          QSerialPort::tr("Frame payload is too large")));
+            return -1;
+        }
+    } else {
+        buffer.append(payload.data(), payload.size());
+        if (!frameDelimiter.isEmpty())
+            buffer.append(frameDelimiter);
+    }
+
+    return encodedSize;
+}
+
+qint64 QSerialPortPrivate::writeAddressed(quint8 address, QByteArrayView payload)
+{
+    // The backend switches to mark parity for the byte at this offset.
+    addressOffsets.append(submittedNormalBytes + writeBuffer.size());
+
+    const char addressByte = char(address);
+    writeBuffer.append(&addressByte, 1);
+    writeBuffer.append(payload.data(), payload.size());
+    recordWriteUnit();
+    coalesceWrite();
+    return payload.size() + 1;
+}
+
+qint64 QSerialPortPrivate::writeFrame(QByteArrayView payload, QSerialPort::WritePriority priority)
+{
+    if (priority == QSerialPort::UrgentPriority) {
+        const qint64 encodedSize = appendFrame(urgentWriteBuffer, payload);
+        if (encodedSize > 0)
+            flushCoalescedWrite();
+        return encodedSize;
+    }
+
+    const qint64 encodedSize = appendFrame(writeBuffer, payload);
+    if (encodedSize >= 0) {
+        recordWriteUnit();
+        coalesceWrite();
+    }
+    return encodedSize;
+}
+
+void QSerialPortPrivate::recordReceiveTimestamp(qint64 chunkEnd)
+{
+    const auto now = std::chrono::steady_clock::now();
+
+    // Forget about the chunks which have been consumed by plain reads.
+    const qint64 readOffset = readStreamOffset();
+    while (!receiveTimestamps.isEmpty() && receiveTimestamps.constFirst().end <= readOffset)
+        receiveTimestamps.removeFirst();
+
+    receiveTimestamps.append({ chunkEnd, now });
+}
+
+void QSerialPortPrivate::updateReadBufferWatermarks()
+{
+    Q_Q(QSerialPort);
+
+    if (readBufferHighWatermark <= 0)
+        return;
+
+    if (!readBufferAboveHighWatermark && buffer.size() >= readBufferHighWatermark) {
+        readBufferAboveHighWatermark = true;
+        if (inputThrottlingEnabled)
+            setInputThrottled(true);
+        emit q->readBufferHighWater();
+    } else if (readBufferAboveHighWatermark && buffer.size() <= readBufferLowWatermark) {
+        readBufferAboveHighWatermark = false;
+        if (inputThrottlingEnabled)
+            setInputThrottled(false);
+        emit q->readBufferLowWater();
+    }
+}
+
+// QIODevice serves partial reads from the buffer without calling
+// readData(), so the level is checked again once the event loop is back
+// in control, which is after the handlers which consume the data.
+void QSerialPortPrivate::scheduleReadBufferWatermarkCheck()
+{
+    Q_Q(QSerialPort);
+
+    if (!readBufferAboveHighWatermark)
+        return;
+
+    if (!readBufferWatermarkTimer) {
+        readBufferWatermarkTimer = new QChronoTimer(q);
+        readBufferWatermarkTimer->setSingleShot(true);
+        QObjectPrivate::connect(readBufferWatermarkTimer, &QChronoTimer::timeout,
+                                this, &QSerialPortPrivate::updateReadBufferWatermarks);
+    }
+    if (!readBufferWatermarkTimer->isActive())
+        readBufferWatermarkTimer->start();
+}
+
+void QSerialPortPrivate::setInputThrottled(bool throttled)
+{
+    Q_Q(QSerialPort);
+
+    if (inputThrottled == throttled)
+        return;
+
+    switch (flowControl.valueBypassingBindings()) {
+    case QSerialPort::NoFlowControl:
+        if (!setRequestToSend(!throttled))
+            return;
+        emit q->requestToSendChanged(!throttled);
+        break;
+    case QSerialPort::SoftwareControl:
+        if (!setInputFlowStopped(throttled))
+            return;
+        break;
+    case QSerialPort::HardwareControl:
+        // RTS is under control of the driver, which deasserts it by itself
+        // once its queue fills up because the backend stops reading.
+        break;
+    }
+
+    inputThrottled = throttled;
+
+    // Reading has stopped while throttled, whichever way the buffered
+    // data has been consumed since.
+    if (!throttled && flowControl.valueBypassingBindings() == QSerialPort::HardwareControl
+            && q->isReadable()) {
+        startAsyncRead();
+    }
+}
+
+bool QSerialPortPrivate::isDiscardingOldestData() const
+{
+    // Data which is part of a transaction must not vanish.
+    return readBufferPolicy == QSerialPort::DiscardOldestData && readBufferMaxSize > 0
+            && !transactionStarted;
+}
+
+void QSerialPortPrivate::discardOldestData(qint64 bytes)
+{
+    // Rather discard whole frames, so that the remaining data still
+    // starts at a frame boundary.
+    const qint64 bufferOffset = receivedBytesTotal - buffer.size();
+    for (const QSerialPortFrame &frame : std::as_const(frames)) {
+        if (frame.end - bufferOffset >= bytes) {
+            bytes = frame.end - bufferOffset;
+            break;
+        }
+    }
+
+    bytes = qMin(bytes, buffer.size());
+    buffer.free(bytes);
+    discardedBytes += bytes;
+}
+
+void QSerialPortPrivate::setReadPaused(bool paused)
+{
+    if (readPaused == paused)
+        return;
+
+    readPaused = paused;
+    if (paused)
+        readPausedSince = std::chrono::steady_clock::now();
+    else
+        readPausedTime += std::chrono::steady_clock::now() - readPausedSince;
+}
+
+// Strips the PARMRK escape sequences from data in place, and records an
+// error for each marked character. Returns the size of the decoded data.
+// An escape at the end of the data is left pending, and has to be put
+// back in front of the next chunk, as the output never grows past the
+// input within a chunk.
+qint64 QSerialPortPrivate::decodeErrorMarks(char *data, qint64 size, qint64 offset)
+{
+    const char *in = data;
+    const char *end = data + size;
+    char *out = data;
+
+    while (in < end) {
+        if (errorMarkState == NoErrorMark) {
+            // Most chunks contain no escape at all, so just skip to the
+            // next one, and only move the data after it.
+            const char *escape = static_cast<const char *>(memchr(in, 0xFF, end - in));
+            const char *blockEnd = escape ? escape : end;
+            if (out != in)
+                memmove(out, in, blockEnd - in);
+            out += blockEnd - in;
+            in = blockEnd;
+            if (!escape)
+                break;
+            ++in;
+            errorMarkState = ErrorMarkEscape;
+            continue;
+        }
+
+        const char c = *in++;
+        if (errorMarkState == ErrorMarkEscape) {
+            // The escape is followed either by itself or by a zero byte.
+            // Anything else is no mark, so both bytes are kept.
+            if (c == '\0') {
+                errorMarkState = ErrorMarkCharacter;
+                continue;
+            }
+            if (c != '\xFF')
+                *out++ = '\xFF';
+            *out++ = c;
+        } else {
+            // A break is reported as a marked zero byte.
+            receiveErrors.append({ offset + (out - data),
+                                   c == '\0' ? QSerialPort::BreakError
+                                              : QSerialPort::ParityOrFramingError });
+            *out++ = c;
+        }
+        errorMarkState = NoErrorMark;
+    }
+
+    // Forget about the errors in the data consumed by plain reads.
+    const qint64 readOffset = readStreamOffset();
+    while (!receiveErrors.isEmpty() && receiveErrors.constFirst().offset < readOffset)
+        receiveErrors.removeFirst();
+
+    return out - data;
+}
+
+qint64 QSerialPortPrivate::readStreamOffset() const
+{
+    qint64 offset = receivedBytesTotal - buffer.size();
+    if (transactionStarted)
+        offset += transactionPos;
+    return offset;
+}
+
+void QSerialPortPrivate::resetFraming()
+{
+    frames.clear();
+    lastFrameEnd = readStreamOffset();
+    frameScanOffset = lastFrameEnd;
+    if (frameDecoder)
+        frameDecoder->reset();
+}
+
+bool QSerialPortPrivate::scanForFrames()
+{
+    const qint64 bufferOffset = receivedBytesTotal - buffer.size();
+
+    // Forget about the frames which have been consumed by plain reads.
+    const qint64 readOffset = readStreamOffset();
+    while (!frames.isEmpty() && frames.constFirst().end <= readOffset)
+        frames.removeFirst();
+    const qsizetype framesFound = frames.size();
+
+    // Only the data received since the last scan has to be searched. The
+    // cursor may lag behind the buffer if it has been cleared meanwhile.
+    qint64 position = qMax(frameScanOffset, bufferOffset);
+
+    if (frameDecoder) {
+        while (position < receivedBytesTotal) {
+            qint64 blockSize = 0;
+            const char *block = buffer.readPointerAtPosition(position - bufferOffset, blockSize);
+            frameDecoder->decode(block, blockSize, position, &frames);
+            position += blockSize;
+        }
+        frameScanOffset = position;
+        return frames.size() > framesFound;
+    }
+
+    const qsizetype delimiterSize = frameDelimiter.size();
+    const char lastDelimiterByte = frameDelimiter.back();
+    while (position < receivedBytesTotal) {
+        qint64 blockSize = 0;
+        const char *block = buffer.readPointerAtPosition(position - bufferOffset, blockSize);
+        const char *match = static_cast<const char *>(memchr(block, lastDelimiterByte, blockSize));
+        if (!match) {
+            position += blockSize;
+            continue;
+        }
+
+        position += match - block + 1;
+
+        // For a multi-byte delimiter, the bytes preceding the match may
+        // belong to an older block, or even to an earlier scan.
+        if (delimiterSize > 1) {
+            if (position - qMax(lastFrameEnd, bufferOffset) < delimiterSize)
+                continue;
+            QVarLengthArray<char, 16> tail(delimiterSize - 1);
+            buffer.peek(tail.data(), delimiterSize - 1, position - bufferOffset - delimiterSize);
+            if (memcmp(tail.constData(), frameDelimiter.constData(), delimiterSize - 1) != 0)
+                continue;
+        }
+
+        QSerialPortFrame frame;
+        frame.payloadStart = lastFrameEnd;
+        frame.payloadEnd = position - delimiterSize;
+        frame.end = position;
+        frames.append(std::move(frame));
+        lastFrameEnd = position;
+    }
+    frameScanOffset = position;
+
+    return frames.size() > framesFound;
+}
+
+bool QSerialPortPrivate::hasPendingFrame() const
+{
+    // Frames are in ascending order, so the last one tells whether
+    // any of them has not been consumed yet.
+    return !frames.isEmpty() && frames.constLast().end > readStreamOffset();
+}
+
+void QSerialPortPrivate::emitFrameReady()
+{
+    Q_Q(QSerialPort);
+
+    // only emit frameReady() when not recursing
+    if (emittedFrameReady)
+        return;
+
+    emittedFrameReady = true;
+    emit q->frameReady();
+    emittedFrameReady = false;
+
+    scheduleReadBufferWatermarkCheck();
+}
+
 /*!
     \class QSerialPort
 
@@ -112,6 +761,12 @@ void QSerialPortPrivate::setError(const QSerialPortErrorInfo &errorInfo)
     QSerialPort's internal read buffer. You can limit the size of the read
     buffer using setReadBufferSize().
 
+    Large payloads passed to write() as a QByteArray are not copied into
+    the internal write buffer. QSerialPort keeps a reference to the
+    implicitly shared data until it has been written to the driver, so
+    modifying the byte array afterwards detaches it and leaves the
+    transmitted data unchanged.
+
     QSerialPort provides a set of functions that suspend the
     calling thread until certain signals are emitted. These functions
     can be used to implement blocking serial ports:
@@ -269,6 +924,82 @@ void QSerialPortPrivate::setError(const QSerialPortErrorInfo &errorInfo)
     \sa QSerialPort::flowControl
 */
 
+/*!
+    \enum QSerialPort::FramingProtocol
+    \since 6.9
+
+    This enum describes the protocols used to split the received data into
+    frames.
+
+    \value NoFraming            Frames are only split at the frameDelimiter(),
+                                if one is set.
+    \value SlipFraming          Serial Line IP (RFC 1055). Frames end with
+                                \c 0xC0, which is escaped with \c 0xDB in the
+                                payload.
+    \value CobsFraming          Consistent Overhead Byte Stuffing. Frames end
+                                with a zero byte, which never occurs in the
+                                encoded payload.
+    \value HdlcFraming          HDLC-like byte stuffing (RFC 1662). Frames are
+                                separated by \c 0x7E, which is escaped with
+                                \c 0x7D in the payload. The frame check
+                                sequence is left in the payload.
+    \value LengthPrefixFraming  Each payload is preceded by its size, as a
+                                big-endian integer of frameLengthPrefixSize()
+                                bytes.
+
+    \sa setFramingProtocol()
+*/
+
+/*!
+    \enum QSerialPort::ReadBufferPolicy
+    \since 6.9
+
+    This enum describes what happens when the read buffer is full.
+
+    \value PauseReading         QSerialPort stops reading from the driver
+                                until data has been read from the buffer.
+                                The data received meanwhile is queued in the
+                                driver.
+    \value DiscardOldestData    QSerialPort keeps reading from the driver and
+                                discards the oldest buffered data.
+
+    \sa setReadBufferPolicy(), setReadBufferSize()
+*/
+
+/*!
+    \enum QSerialPort::ReceiveErrorType
+    \since 6.9
+
+    This enum describes the errors reported by receiveErrors().
+
+    \value ParityOrFramingError A character was received with a parity or
+                                a framing error.
+    \value BreakError           A break condition was detected on the line,
+                                it is received as a zero byte.
+
+    \note The driver marks a break in the same way as a zero byte received
+    with a parity or framing error. A marked zero byte is always reported as
+    BreakError, so it may as well be a ParityOrFramingError.
+
+    \sa setReceiveErrorMarkingEnabled()
+*/
+
+/*!
+    \enum QSerialPort::WritePriority
+    \since 6.9
+
+    This enum describes the lane in which outgoing data is queued.
+
+    \value NormalPriority       The data is written in the order of the
+                                calls to write() and writeFrame().
+    \value UrgentPriority       The data is written ahead of the normal
+                                priority data which has not been handed to
+                                the driver yet, right after the end of the
+                                normal priority write in progress.
+
+    \sa writeUrgent(), writeFrame(), submittedBytes()
+*/
+
 /*!
     \enum QSerialPort::PinoutSignal
 
@@ -459,6 +1190,14 @@ bool QSerialPort::open(OpenMode mode)
     }
 
     clearError();
+    d->readPausedTime = std::chrono::nanoseconds::zero();
+    d->discardedBytes = 0;
+    d->coalescedWrites = 0;
+    d->queuedWriteCount = 0;
+    d->submittedNormalBytes = 0;
+    d->submittedUrgentBytes = 0;
+    d->writeUnitStart = 0;
+    d->errorMarkState = QSerialPortPrivate::NoErrorMark;
     if (!d->open(mode))
         return false;
 
@@ -483,8 +1222,22 @@ void QSerialPort::close()
     }
 
     d->close();
+    if (d->readyReadTimer)
+        d->readyReadTimer->stop();
+    d->unreportedReadBytes = 0;
+    if (d->writeCoalescingTimer)
+        d->writeCoalescingTimer->stop();
+    if (d->transmitCompleteTimer)
+        d->transmitCompleteTimer->stop();
+    if (d->readBufferWatermarkTimer)
+        d->readBufferWatermarkTimer->stop();
     d->isBreakEnabled.setValue(false);
     QIODevice::close();
+    d->clearWriteLanes();
+    d->resetFraming();
+    d->setReadPaused(false);
+    d->readBufferAboveHighWatermark = false;
+    d->inputThrottled = false;
 }
 
 /*!
@@ -756,13 +1509,214 @@ QBindable<QSerialPort::FlowControl> QSerialPort::bindableFlowControl()
 */
 
 /*!
-    \property QSerialPort::dataTerminalReady
-    \brief the state (high or low) of the line signal DTR
+    \since 6.9
 
-    Returns \c true on success, \c false otherwise.
-    If the flag is \c true then the DTR signal is set to high; otherwise low.
+    Sets the minimum number of bytes that the driver has to receive before
+    it reports the port as readable to \a bytes. This corresponds to the
+    \c VMIN setting of the terminal.
 
-    \note The serial port has to be open before trying to set or get this
+    If the setting is successful or set before opening the port, returns
+    \c true; otherwise returns \c false and sets an error code which can be
+    obtained by accessing the value of the QSerialPort::error property.
+
+    Batching the input in the driver considerably reduces the number of
+    wakeups per frame for protocols with fixed-size frames. With the event
+    loop, readyRead() is not emitted until at least \a bytes bytes have
+    arrived, so a partial batch at the end of a transmission is held back
+    until more data arrives. Only waitForReadyRead() and
+    waitForBytesWritten() pick up a partial batch, and only if an
+    inter-byte timeout is set with setInterByteTimeout().
+
+    Valid values are in the range from \c 0 to \c 255. The default value
+    is \c 0, i.e. the port is readable as soon as any data has been
+    received. The original setting of the terminal is restored on close().
+
+    \note This setting is only supported on Unix platforms. On other
+    platforms, a value set before opening the port is accepted, but it is
+    ignored when the port is opened.
+
+    \sa minimumReadSize(), setInterByteTimeout()
+*/
+bool QSerialPort::setMinimumReadSize(int bytes)
+{
+    Q_D(QSerialPort);
+
+    if (bytes < 0 || bytes > 255) {
+        d->setError(QSerialPortErrorInfo(QSerialPort::UnsupportedOperationError,
+                                         tr("Invalid minimum read size")));
+        return false;
+    }
+
+    if (!isOpen() || d->setMinimumReadSize(bytes)) {
+        d->minimumReadSize = bytes;
+        return true;
+    }
+    return false;
+}
+
+/*!
+    \since 6.9
+
+    Returns the minimum number of bytes that the driver has to receive
+    before it reports the port as readable.
+
+    \sa setMinimumReadSize()
+*/
+int QSerialPort::minimumReadSize() const
+{
+    Q_D(const QSerialPort);
+    return d->minimumReadSize;
+}
+
+/*!
+    \class QSerialPort::Rs485Settings
+    \inmodule QtSerialPort
+    \since 6.9
+
+    \brief The Rs485Settings class holds the configuration of the RS-485
+    mode of the serial port driver.
+
+    \sa QSerialPort::setRs485Settings()
+*/
+
+/*!
+    \variable QSerialPort::Rs485Settings::enabled
+
+    Whether the driver toggles the RTS signal around each transmission.
+    The default is \c false.
+*/
+
+/*!
+    \variable QSerialPort::Rs485Settings::rtsOnSend
+
+    Whether RTS is asserted while the data is sent. The default is
+    \c true.
+*/
+
+/*!
+    \variable QSerialPort::Rs485Settings::rtsAfterSend
+
+    Whether RTS is asserted after the data has been sent. The default is
+    \c false.
+*/
+
+/*!
+    \variable QSerialPort::Rs485Settings::receiveDuringTransmit
+
+    Whether the receiver stays enabled while the data is sent, so that the
+    transmitted data is echoed back. The default is \c false.
+*/
+
+/*!
+    \variable QSerialPort::Rs485Settings::delayBeforeSend
+
+    The time between asserting RTS and sending the first character.
+*/
+
+/*!
+    \variable QSerialPort::Rs485Settings::delayAfterSend
+
+    The time between sending the last character and releasing RTS.
+*/
+
+/*!
+    \since 6.9
+
+    Sets the RS-485 mode of the driver to \a settings.
+
+    In this mode the driver switches the transceiver of a half-duplex
+    RS-485 bus between transmission and reception by itself, with the
+    timing configured in \a settings. This avoids toggling the RTS signal
+    from the application with setRequestToSend(), which costs a system call
+    and adds jitter for each transmission.
+
+    If the setting is successful or set before opening the port, returns
+    \c true; otherwise returns \c false and sets an error code, for example
+    UnsupportedOperationError if the driver has no RS-485 support. If the
+    setting is set before opening the port, it is applied when the port is
+    opened, and open() fails if the driver rejects it. The previous RS-485
+    configuration of the driver is restored when the port is closed.
+
+    \note This setting is only supported on Linux, through the
+    \c TIOCSRS485 ioctl.
+
+    \sa rs485Settings()
+*/
+bool QSerialPort::setRs485Settings(const Rs485Settings &settings)
+{
+    Q_D(QSerialPort);
+
+    if (settings.delayBeforeSend.count() < 0 || settings.delayAfterSend.count() < 0) {
+        d->setError(QSerialPortErrorInfo(QSerialPort::UnsupportedOperationError,
+                                         tr("Invalid RS-485 delay")));
+        return false;
+    }
+
+    if (!isOpen() || d->setRs485(settings)) {
+        d->rs485Settings = settings;
+        return true;
+    }
+    return false;
+}
+
+/*!
+    \since 6.9
+
+    Returns the RS-485 mode configuration of the driver.
+
+    \sa setRs485Settings()
+*/
+QSerialPort::Rs485Settings QSerialPort::rs485Settings() const
+{
+    Q_D(const QSerialPort);
+    return d->rs485Settings;
+}
+
+/*!
+    \since 6.9
+
+    Sets the inter-byte timeout used together with minimumReadSize() to
+    \a timeout.
+
+    If the driver holds less than minimumReadSize() bytes and no further
+    byte has arrived for \a timeout, the partial batch is reported as
+    readable by waitForReadyRead() and waitForBytesWritten(). A timeout of
+    \c 0 (the default) means that partial batches are only reported once
+    the minimum read size is reached.
+
+    Because the port is operated in non-blocking mode, in which the terminal
+    ignores its \c VTIME setting, the timeout is applied by QSerialPort
+    rather than by the driver, and only by the blocking functions.
+
+    \sa interByteTimeout(), setMinimumReadSize()
+*/
+void QSerialPort::setInterByteTimeout(std::chrono::milliseconds timeout)
+{
+    Q_D(QSerialPort);
+    d->interByteTimeout = qMax(timeout, std::chrono::milliseconds::zero());
+}
+
+/*!
+    \since 6.9
+
+    Returns the inter-byte timeout used together with minimumReadSize().
+
+    \sa setInterByteTimeout()
+*/
+std::chrono::milliseconds QSerialPort::interByteTimeout() const
+{
+    Q_D(const QSerialPort);
+    return d->interByteTimeout;
+}
+
+/*!
+    \property QSerialPort::dataTerminalReady
+    \brief the state (high or low) of the line signal DTR
+
+    Returns \c true on success, \c false otherwise.
+    If the flag is \c true then the DTR signal is set to high; otherwise low.
+
+    \note The serial port has to be open before trying to set or get this
     property; otherwise \c false is returned and the error code is set to
     NotOpenError.
 
@@ -914,6 +1868,8 @@ bool QSerialPort::flush()
         return false;
     }
 
+    if (d->writeCoalescingTimer)
+        d->writeCoalescingTimer->stop();
     return d->flush();
 }
 
@@ -936,10 +1892,13 @@ bool QSerialPort::clear(Directions directions)
         return false;
     }
 
-    if (directions & Input)
+    if (directions & Input) {
         d->buffer.clear();
+        d->resetFraming();
+        d->updateReadBufferWatermarks();
+    }
     if (directions & Output)
-        d->writeBuffer.clear();
+        d->clearWriteLanes();
     return d->clear(directions);
 }
 
@@ -1022,172 +1981,1529 @@ void QSerialPort::setReadBufferSize(qint64 size)
 }
 
 /*!
-    \reimp
+    \since 6.9
 
-    Always returns \c true. The serial port is a sequential device.
+    Returns what happens when the read buffer reaches the
+    readBufferSize().
+
+    \sa setReadBufferPolicy()
 */
-bool QSerialPort::isSequential() const
+QSerialPort::ReadBufferPolicy QSerialPort::readBufferPolicy() const
 {
-    return true;
+    Q_D(const QSerialPort);
+    return d->readBufferPolicy;
 }
 
 /*!
-    \reimp
+    \since 6.9
 
-    Returns the number of incoming bytes that are waiting to be read.
+    Sets what happens when the read buffer reaches the readBufferSize() to
+    \a policy. The default is PauseReading.
 
-    \sa bytesToWrite(), read()
+    With DiscardOldestData, QSerialPort keeps reading from the driver when
+    the buffer is full, and discards as many of the oldest buffered bytes
+    as needed to stay within the readBufferSize(). If a frameDelimiter() or
+    a framingProtocol() is set, whole frames are discarded where possible.
+    This keeps the latency bounded for applications which are only
+    interested in the most recent data, for example live telemetry.
+
+    No data is discarded while a transaction is in progress.
+
+    \sa readBufferPolicy(), discardedBytes(), setReadBufferSize()
 */
-qint64 QSerialPort::bytesAvailable() const
+void QSerialPort::setReadBufferPolicy(ReadBufferPolicy policy)
 {
-    return QIODevice::bytesAvailable();
+    Q_D(QSerialPort);
+    d->readBufferPolicy = policy;
+    if (isReadable())
+        d->startAsyncRead();
 }
 
 /*!
-    \reimp
+    \since 6.9
 
-    Returns the number of bytes that are waiting to be written. The
-    bytes are written when control goes back to the event loop or
-    when flush() is called.
+    Returns the number of received bytes which have been discarded since
+    the port was opened, because the read buffer was full and the
+    readBufferPolicy() is DiscardOldestData.
 
-    \sa bytesAvailable(), flush()
+    \sa setReadBufferPolicy()
 */
-qint64 QSerialPort::bytesToWrite() const
+qint64 QSerialPort::discardedBytes() const
 {
-    qint64 pendingBytes = QIODevice::bytesToWrite();
-#if defined(Q_OS_WIN32)
-    pendingBytes += d_func()->writeChunkBuffer.size();
-#endif
-    return pendingBytes;
+    Q_D(const QSerialPort);
+    return d->discardedBytes;
 }
 
 /*!
-    \reimp
+    \since 6.9
 
-    Returns \c true if a line of data can be read from the serial port;
-    otherwise returns \c false.
+    Returns the number of buffered bytes at which readBufferHighWater() is
+    emitted, or \c 0 if the watermarks are disabled.
 
-    \sa readLine()
+    \sa setReadBufferHighWatermark(), readBufferLowWatermark()
 */
-bool QSerialPort::canReadLine() const
+qint64 QSerialPort::readBufferHighWatermark() const
 {
-    return QIODevice::canReadLine();
+    Q_D(const QSerialPort);
+    return d->readBufferHighWatermark;
 }
 
 /*!
-    \reimp
+    \since 6.9
 
-    This function blocks until new data is available for reading and the
-    \l{QIODevice::}{readyRead()} signal has been emitted. The function
-    will timeout after \a msecs milliseconds; the default timeout is
-    30000 milliseconds. If \a msecs is -1, this function will not time out.
+    Sets the number of buffered bytes at which readBufferHighWater() is
+    emitted to \a bytes. A value of \c 0 (the default) disables the
+    watermarks.
 
-    The function returns \c true if the readyRead() signal is emitted and
-    there is new data available for reading; otherwise it returns \c false
-    (if an error occurred or the operation timed out).
+    When the internal read buffer fills up because the application does
+    not read the data fast enough, readBufferHighWater() is emitted once
+    it holds at least \a bytes bytes. Once it has been drained to the
+    readBufferLowWatermark(), readBufferLowWater() is emitted. This gives
+    the application a chance to shed load before the readBufferSize() is
+    reached, at which point QSerialPort stops reading and the data backs up
+    in the driver.
 
-    \sa waitForBytesWritten()
+    The readBufferLowWatermark() is lowered to below \a bytes if needed.
+
+    \sa readBufferHighWatermark(), setReadBufferLowWatermark(), readPausedTime()
 */
-bool QSerialPort::waitForReadyRead(int msecs)
+void QSerialPort::setReadBufferHighWatermark(qint64 bytes)
 {
     Q_D(QSerialPort);
-    return d->waitForReadyRead(msecs);
+    d->readBufferHighWatermark = qMax(bytes, qint64(0));
+    if (d->readBufferHighWatermark > 0)
+        d->readBufferLowWatermark = qMin(d->readBufferLowWatermark, d->readBufferHighWatermark - 1);
+    d->updateReadBufferWatermarks();
 }
 
 /*!
-    \fn Handle QSerialPort::handle() const
-    \since 5.2
+    \since 6.9
 
-    If the platform is supported and the serial port is open, returns the native
-    serial port handle; otherwise returns \c -1.
+    Returns the number of buffered bytes at which readBufferLowWater() is
+    emitted after the high watermark has been reached.
 
-    \warning This function is for expert use only; use it at your own risk.
-    Furthermore, this function carries no compatibility promise between minor
-    Qt releases.
+    \sa setReadBufferLowWatermark(), readBufferHighWatermark()
+*/
+qint64 QSerialPort::readBufferLowWatermark() const
+{
+    Q_D(const QSerialPort);
+    return d->readBufferLowWatermark;
+}
+
+/*!
+    \since 6.9
+
+    Sets the number of buffered bytes at which readBufferLowWater() is
+    emitted after the high watermark has been reached to \a bytes. The
+    default is \c 0, that is when the read buffer has been emptied. The
+    value is clamped to below the readBufferHighWatermark().
+
+    The buffer level is checked whenever data is received, cleared or read
+    with readFrame() or readWithTimestamps(), and once control returns to
+    the event loop after readyRead() or frameReady() has been emitted.
+    Reads with the QIODevice API, such as read(), readLine() or getChar(),
+    are served from the buffer without notifying QSerialPort, so outside
+    of these handlers they are only noticed when more data is requested
+    than is buffered, that is at the latest once the buffer is empty.
+
+    \sa readBufferLowWatermark(), setReadBufferHighWatermark()
 */
+void QSerialPort::setReadBufferLowWatermark(qint64 bytes)
+{
+    Q_D(QSerialPort);
+    if (d->readBufferHighWatermark > 0)
+        bytes = qMin(bytes, d->readBufferHighWatermark - 1);
+    d->readBufferLowWatermark = qMax(bytes, qint64(0));
+    d->updateReadBufferWatermarks();
+}
 
 /*!
-    \reimp
+    \since 6.9
 
-    This function blocks until at least one byte has been written to the serial
-    port and the \l{QIODevice::}{bytesWritten()} signal has been emitted. The
-    function will timeout after \a msecs milliseconds; the default timeout is
-    30000 milliseconds. If \a msecs is -1, this function will not time out.
+    Returns \c true if the peer is asked to pause sending while the read
+    buffer is above the readBufferHighWatermark(); otherwise returns
+    \c false.
 
-    The function returns \c true if the bytesWritten() signal is emitted; otherwise
-    it returns \c false (if an error occurred or the operation timed out).
+    \sa setInputThrottlingEnabled(), isInputThrottled()
 */
-bool QSerialPort::waitForBytesWritten(int msecs)
+bool QSerialPort::isInputThrottlingEnabled() const
 {
-    Q_D(QSerialPort);
-    return d->waitForBytesWritten(msecs);
+    Q_D(const QSerialPort);
+    return d->inputThrottlingEnabled;
 }
 
 /*!
-    \property QSerialPort::breakEnabled
-    \since 5.5
-    \brief the state of the transmission line in break
+    \since 6.9
 
-    Returns \c true on success, \c false otherwise.
-    If the flag is \c true then the transmission line is in break state;
-    otherwise is in non-break state.
+    If \a enable is \c true, the peer is asked to pause sending when the
+    internal read buffer reaches the readBufferHighWatermark(), and to
+    resume when it has been drained to the readBufferLowWatermark(). This
+    is disabled by default.
 
-    \note The serial port has to be open before trying to set or get this
-    property; otherwise returns \c false and sets the NotOpenError error code.
-    This is a bit unusual as opposed to the regular Qt property settings of
-    a class. However, this is a special use case since the property is set
-    through the interaction with the kernel and hardware. Hence, the two
-    scenarios cannot be completely compared to each other.
+    The driver only throttles the peer based on its own queue, so without
+    this setting the peer keeps sending while the data piles up in
+    QSerialPort. Together with the watermarks, throttling bounds the memory
+    used for the read buffer without losing data, provided that the peer
+    obeys the flow control. How the peer is asked to pause depends on the
+    flowControl():
+
+    \table
+    \header
+        \li Flow control
+        \li Throttling
+    \row
+        \li NoFlowControl
+        \li The RTS line is deasserted, as with setRequestToSend(). The
+            application should not change the RTS line itself meanwhile.
+    \row
+        \li SoftwareControl
+        \li An XOFF character is sent, and an XON character to resume.
+    \row
+        \li HardwareControl
+        \li QSerialPort stops reading from the driver, which then deasserts
+            RTS once its own queue is full.
+    \endtable
+
+    \sa isInputThrottlingEnabled(), setReadBufferHighWatermark()
 */
-bool QSerialPort::setBreakEnabled(bool set)
+void QSerialPort::setInputThrottlingEnabled(bool enable)
 {
     Q_D(QSerialPort);
-    d->isBreakEnabled.removeBindingUnlessInWrapper();
-    const auto currentSet = d->isBreakEnabled.valueBypassingBindings();
-    if (isOpen()) {
-        if (d->setBreakEnabled(set)) {
-            d->isBreakEnabled.setValueBypassingBindings(set);
-            if (currentSet != set) {
-                d->isBreakEnabled.notify();
-                emit breakEnabledChanged(set);
-            }
-            return true;
-        }
-    } else {
-        d->setError(QSerialPortErrorInfo(QSerialPort::NotOpenError));
-        qWarning("%s: device not open", Q_FUNC_INFO);
-    }
-    return false;
+
+    d->inputThrottlingEnabled = enable;
+    if (isOpen())
+        d->setInputThrottled(enable && d->readBufferAboveHighWatermark);
 }
 
-bool QSerialPort::isBreakEnabled() const
+/*!
+    \since 6.9
+
+    Returns \c true if the peer is currently asked to pause sending,
+    because the read buffer has reached the readBufferHighWatermark().
+
+    \sa setInputThrottlingEnabled()
+*/
+bool QSerialPort::isInputThrottled() const
 {
     Q_D(const QSerialPort);
-    return d->isBreakEnabled;
+    return d->inputThrottled;
 }
 
-QBindable<bool> QSerialPort::bindableIsBreakEnabled()
+/*!
+    \since 6.9
+
+    Returns the total time during which QSerialPort has stopped reading
+    from the driver since the port was opened, because the read buffer was
+    full. The data received meanwhile is queued in the driver, and may get
+    lost once the driver queue overflows.
+
+    \sa setReadBufferSize(), setReadBufferHighWatermark()
+*/
+std::chrono::nanoseconds QSerialPort::readPausedTime() const
 {
-    return &d_func()->isBreakEnabled;
+    Q_D(const QSerialPort);
+    auto pausedTime = d->readPausedTime;
+    if (d->readPaused)
+        pausedTime += std::chrono::steady_clock::now() - d->readPausedSince;
+    return pausedTime;
 }
 
 /*!
-    \reimp
+    \fn void QSerialPort::readBufferHighWater()
+    \since 6.9
 
-    \omit
-    This function does not really read anything, as we use QIODevicePrivate's
-    buffer. The buffer will be read inside of QIODevice before this
-    method will be called.
-    \endomit
+    This signal is emitted when the internal read buffer has filled up to
+    the readBufferHighWatermark().
+
+    \sa readBufferLowWater()
 */
-qint64 QSerialPort::readData(char *data, qint64 maxSize)
+
+/*!
+    \fn void QSerialPort::readBufferLowWater()
+    \since 6.9
+
+    This signal is emitted when the internal read buffer has been drained
+    to the readBufferLowWatermark(), after readBufferHighWater() was
+    emitted.
+
+    \sa readBufferHighWater()
+*/
+
+/*!
+    \fn void QSerialPort::transmitComplete()
+    \since 6.9
+
+    This signal is emitted when all the written data has left the
+    transmitter of the serial port, unlike bytesWritten(), which is emitted
+    as soon as the data has been handed to the driver. A half-duplex
+    device, for example on an RS-485 bus, may then turn the bus around.
+
+    QSerialPort only polls the driver for the transmitter state while this
+    signal is connected. The polling interval adapts to the time the data
+    still queued in the driver takes on the wire at the current baud rate.
+
+    \note On Unix, the state of the shift register of the transmitter is
+    only known if the driver supports \c TIOCSERGETLSR, otherwise only the
+    output queue of the driver is checked. On Windows, only the output
+    queue of the driver is checked.
+
+    \sa waitForTransmitComplete(), bytesWritten(), kernelBytesToWrite()
+*/
+
+/*!
+    \since 6.9
+
+    Returns the maximum number of bytes that QSerialPort requests from the
+    driver with a single read operation.
+
+    The default value is 32768 bytes.
+
+    \sa setReadChunkSize(), isAdaptiveReadChunkSizeEnabled()
+*/
+qint64 QSerialPort::readChunkSize() const
+{
+    Q_D(const QSerialPort);
+    return d->readBufferChunkSize;
+}
+
+/*!
+    \since 6.9
+
+    Sets the maximum number of bytes that QSerialPort requests from the
+    driver with a single read operation to \a size bytes.
+
+    A larger chunk reduces the number of system calls at high baud rates,
+    while a smaller chunk reduces the amount of memory reserved for ports
+    which receive little data. The size of the internal read buffer is not
+    affected; use setReadBufferSize() to limit it.
+
+    If the adaptive mode is enabled, \a size is the upper limit of the
+    chunk size.
+
+    \sa readChunkSize(), setAdaptiveReadChunkSizeEnabled()
+*/
+void QSerialPort::setReadChunkSize(qint64 size)
+{
+    Q_D(QSerialPort);
+
+    if (size <= 0) {
+        qWarning("%s: invalid chunk size %lld", Q_FUNC_INFO, size);
+        return;
+    }
+
+    d->readBufferChunkSize = size;
+    d->currentReadChunkSize = qMin(d->currentReadChunkSize, size);
+}
+
+/*!
+    \since 6.9
+
+    Returns \c true if the read chunk size is adapted to the incoming data
+    rate; otherwise returns \c false.
+
+    The adaptive mode is disabled by default.
+
+    \sa setAdaptiveReadChunkSizeEnabled(), readChunkSize()
+*/
+bool QSerialPort::isAdaptiveReadChunkSizeEnabled() const
+{
+    Q_D(const QSerialPort);
+    return d->adaptiveReadChunkSize;
+}
+
+/*!
+    \since 6.9
+
+    If \a enable is \c true, QSerialPort starts reading with a small chunk,
+    doubles the chunk each time a read fills it completely, and halves it
+    again when the reads stay small, without ever exceeding readChunkSize().
+    If \a enable is \c false, every read requests readChunkSize() bytes.
+
+    On Unix, a read only requests as many bytes as the driver reports to
+    be queued, which may be less than the chunk. The chunk is then adapted
+    to the number of queued bytes instead, so it grows when the backlog in
+    the driver fills it, and shrinks when the backlog stays small.
+
+    \sa isAdaptiveReadChunkSizeEnabled(), setReadChunkSize()
+*/
+void QSerialPort::setAdaptiveReadChunkSizeEnabled(bool enable)
+{
+    Q_D(QSerialPort);
+    d->adaptiveReadChunkSize = enable;
+    d->currentReadChunkSize = qMin(qint64(QSERIALPORT_MIN_READ_CHUNKSIZE),
+                                   qint64(d->readBufferChunkSize));
+    d->shortReadCount = 0;
+}
+
+/*!
+    \since 6.9
+
+    Returns \c true if the data is read from the driver into a buffer which
+    is allocated once when the port is opened; otherwise returns \c false.
+
+    \sa setPreallocatedReadBufferEnabled()
+*/
+bool QSerialPort::isPreallocatedReadBufferEnabled() const
+{
+    Q_D(const QSerialPort);
+    return d->preallocatedReadBuffer;
+}
+
+/*!
+    \since 6.9
+
+    If \a enable is \c true, the data is read from the driver into a buffer
+    of readChunkSize() bytes, which is allocated when the port is opened and
+    reused for every read. Only the bytes actually received are then
+    appended to the internal read buffer. This is disabled by default.
+
+    Otherwise, space for a whole chunk is reserved in the internal read
+    buffer before each read, which may allocate memory even if only a few
+    bytes are received. With many ports open, or with many small reads,
+    the preallocated buffer reduces the memory usage and the load on the
+    memory allocator, at the cost of copying the received bytes once.
+
+    \note This setting only has an effect on Unix platforms. On Windows,
+    the data is always read into a preallocated buffer.
+
+    \sa isPreallocatedReadBufferEnabled(), setReadChunkSize()
+*/
+void QSerialPort::setPreallocatedReadBufferEnabled(bool enable)
+{
+    Q_D(QSerialPort);
+    d->preallocatedReadBuffer = enable;
+}
+
+/*!
+    \since 6.9
+
+    Returns \c true if the port is served by a dedicated I/O thread once it
+    is opened; otherwise returns \c false.
+
+    \sa setIoThreadEnabled()
+*/
+bool QSerialPort::isIoThreadEnabled() const
+{
+    Q_D(const QSerialPort);
+    return d->ioThreadEnabled;
+}
+
+/*!
+    \since 6.9
+
+    If \a enable is \c true, the next open() starts a thread which is
+    dedicated to the port. This is disabled by default.
+
+    The I/O thread waits for the port itself, and reads the received data as
+    soon as it arrives, into a buffer which is shared with the thread of
+    the QSerialPort object without any locking. The data written is handed
+    over to the I/O thread in the same way. The readyRead() and
+    bytesWritten() signals are still emitted from the event loop of the
+    thread of the QSerialPort object, once for all the data transferred in
+    the meantime, and the API is used exactly as without the I/O thread.
+
+    This keeps the data flowing while the event loop is busy, for example
+    with a slow user interface, instead of letting the driver queue
+    overflow. The I/O thread buffers at most readChunkSize() or 32 KiB of
+    received data, whichever is larger; past that, reading pauses just as
+    without the I/O thread.
+
+    The data written with mark or space parity emulated in software, and
+    the multidrop frames of writeAddressed(), are still written from the
+    thread of the QSerialPort object, as the parity has to be switched in
+    step with the data. The setImmediateWriteEnabled() setting has no
+    effect, as the written data is always handed over right away.
+
+    \note The written data already handed over to the I/O thread is not
+    discarded by clear(). This setting only has an effect on Unix platforms.
+
+    \sa isIoThreadEnabled(), setReadChunkSize()
+*/
+void QSerialPort::setIoThreadEnabled(bool enable)
+{
+    Q_D(QSerialPort);
+    d->ioThreadEnabled = enable;
+}
+
+/*!
+    \since 6.9
+
+    Returns the maximum number of bytes that QSerialPort reads from the
+    driver in response to a single read notification.
+
+    A budget of \c 0 (the default) means that only one read operation of
+    up to readChunkSize() bytes is performed per notification.
+
+    \sa setReadDrainBudget()
+*/
+qint64 QSerialPort::readDrainBudget() const
+{
+    Q_D(const QSerialPort);
+    return d->readDrainBudget;
+}
+
+/*!
+    \since 6.9
+
+    Sets the per-notification read budget to \a bytes.
+
+    If the budget is greater than \c 0, QSerialPort keeps reading from the
+    driver after a read notification, until the driver has no more data
+    queued, the budget is used up or the read buffer is full. All the data
+    read this way is then reported with a single readyRead() signal. Under
+    bursty traffic, this saves event loop iterations and signal emissions.
+
+    \note This setting only has an effect on Unix platforms. On Windows, a
+    new read operation is started right away while the driver has data
+    queued.
+
+    \sa readDrainBudget(), setReadChunkSize()
+*/
+void QSerialPort::setReadDrainBudget(qint64 bytes)
+{
+    Q_D(QSerialPort);
+    d->readDrainBudget = qMax(bytes, qint64(0));
+}
+
+/*!
+    \since 6.9
+
+    Returns the number of newly received bytes required before readyRead()
+    is emitted.
+
+    A threshold of \c 0 (the default) means that readyRead() is emitted as
+    soon as any new data has been received.
+
+    \sa setReadyReadThreshold(), readyReadLatency()
+*/
+qint64 QSerialPort::readyReadThreshold() const
+{
+    Q_D(const QSerialPort);
+    return d->readyReadThreshold;
+}
+
+/*!
+    \since 6.9
+
+    Sets the number of newly received bytes required before readyRead() is
+    emitted to \a bytes.
+
+    Slow links often deliver data in very small pieces, each of which
+    results in a separate readyRead() signal. With a threshold, the signal
+    is only emitted once at least \a bytes bytes have been received since
+    the previous readyRead(), or once the readyReadLatency() has passed
+    since the oldest byte not yet reported was received. Data left in the
+    read buffer by the application does not count again.
+
+    The threshold only affects the emission of readyRead(), it neither
+    changes the settings of the driver nor the behavior of
+    waitForReadyRead().
+
+    \note If the threshold is larger than readBufferSize() and no latency is
+    set, readyRead() is never emitted.
+
+    \sa readyReadThreshold(), setReadyReadLatency()
+*/
+void QSerialPort::setReadyReadThreshold(qint64 bytes)
+{
+    Q_D(QSerialPort);
+    d->readyReadThreshold = qMax(bytes, qint64(0));
+}
+
+/*!
+    \since 6.9
+
+    Returns the longest time that received data is held back before
+    readyRead() is emitted.
+
+    A latency of \c 0 (the default) means that there is no time limit, and
+    the readyReadThreshold() alone decides when readyRead() is emitted.
+
+    \sa setReadyReadLatency(), readyReadThreshold()
+*/
+std::chrono::microseconds QSerialPort::readyReadLatency() const
+{
+    Q_D(const QSerialPort);
+    return d->readyReadLatency;
+}
+
+/*!
+    \since 6.9
+
+    Sets the longest time that received data is held back before readyRead()
+    is emitted to \a latency.
+
+    If \a latency is greater than zero, data received by QSerialPort is
+    reported with a single readyRead() signal at most \a latency after its
+    first byte arrived, even if the readyReadThreshold() has not been
+    reached. Together with the threshold, this allows trading latency for
+    throughput.
+
+    \sa readyReadLatency(), setReadyReadThreshold()
+*/
+void QSerialPort::setReadyReadLatency(std::chrono::microseconds latency)
+{
+    Q_D(QSerialPort);
+    d->readyReadLatency = qMax(latency, std::chrono::microseconds::zero());
+}
+
+/*!
+    \since 6.9
+
+    Returns \c true if write() hands the data to the driver right away when
+    no data is queued; otherwise returns \c false.
+
+    \sa setImmediateWriteEnabled()
+*/
+bool QSerialPort::isImmediateWriteEnabled() const
+{
+    Q_D(const QSerialPort);
+    return d->immediateWrite;
+}
+
+/*!
+    \since 6.9
+
+    If \a enable is \c true, write() attempts to write the data to the
+    driver immediately, without blocking, as long as no previously written
+    data is still waiting in the internal write buffer. Only the bytes which
+    the driver does not accept are buffered, and written once the port is
+    ready for more data. This is disabled by default.
+
+    Otherwise, the data is always buffered, and is first written to the
+    driver on the next iteration of the event loop. This allows several
+    consecutive calls to write() to be combined into a single write
+    operation, but delays the transmission of short requests.
+
+    In both modes, the bytesWritten() signal is emitted from the event loop,
+    never from within write().
+
+    \note On Windows, enabling this setting starts the asynchronous write
+    operation from within write() instead of from the event loop.
+
+    \sa isImmediateWriteEnabled(), bytesToWrite()
+*/
+void QSerialPort::setImmediateWriteEnabled(bool enable)
+{
+    Q_D(QSerialPort);
+    d->immediateWrite = enable;
+}
+
+/*!
+    \since 6.9
+
+    Returns the maximum time for which written data is held back, waiting
+    to be written to the driver together with the data of subsequent
+    writes.
+
+    A delay of \c 0 (the default) disables the write coalescing.
+
+    \sa setWriteCoalescingDelay(), writeCoalescingSize(), coalescedWrites()
+*/
+std::chrono::microseconds QSerialPort::writeCoalescingDelay() const
+{
+    Q_D(const QSerialPort);
+    return d->writeCoalescingDelay;
+}
+
+/*!
+    \since 6.9
+
+    Sets the maximum time for which written data is held back to \a delay.
+
+    Writing many small pieces of data, for example single bytes in a loop,
+    costs a write operation on the driver for each of them as soon as the
+    event loop runs. With a non-zero delay, the data is queued for up to
+    \a delay after the first write, or until writeCoalescingSize() bytes
+    have accumulated, and is then written to the driver in a single
+    operation. This trades latency for fewer system calls.
+
+    Calling flush() or waitForBytesWritten() writes the queued data right
+    away. While the coalescing is enabled, setImmediateWriteEnabled() has
+    no effect.
+
+    \sa writeCoalescingDelay(), setWriteCoalescingSize(), coalescedWrites()
+*/
+void QSerialPort::setWriteCoalescingDelay(std::chrono::microseconds delay)
+{
+    Q_D(QSerialPort);
+    d->writeCoalescingDelay = qMax(delay, std::chrono::microseconds::zero());
+}
+
+/*!
+    \since 6.9
+
+    Returns the number of queued bytes at which the data is written to the
+    driver without waiting for the rest of writeCoalescingDelay().
+
+    A size of \c 0 (the default) means that only the delay applies.
+
+    \sa setWriteCoalescingSize()
+*/
+qint64 QSerialPort::writeCoalescingSize() const
+{
+    Q_D(const QSerialPort);
+    return d->writeCoalescingSize;
+}
+
+/*!
+    \since 6.9
+
+    Sets the number of queued bytes at which the coalescing window is
+    closed early to \a bytes.
+
+    This setting only has an effect if writeCoalescingDelay() is non-zero.
+
+    \sa writeCoalescingSize(), setWriteCoalescingDelay()
+*/
+void QSerialPort::setWriteCoalescingSize(qint64 bytes)
+{
+    Q_D(QSerialPort);
+    d->writeCoalescingSize = qMax(bytes, qint64(0));
+}
+
+/*!
+    \since 6.9
+
+    Returns the number of writes since the port was opened whose data was
+    written to the driver along with the data of a preceding write, and so
+    did not need a write operation of its own.
+
+    This includes the writes merged because they happened before the event
+    loop ran, as well as the ones held back by the coalescing window.
+
+    \sa setWriteCoalescingDelay()
+*/
+qint64 QSerialPort::coalescedWrites() const
+{
+    Q_D(const QSerialPort);
+    return d->coalescedWrites;
+}
+
+/*!
+    \reimp
+
+    Always returns \c true. The serial port is a sequential device.
+*/
+bool QSerialPort::isSequential() const
+{
+    return true;
+}
+
+/*!
+    \reimp
+
+    Returns the number of incoming bytes that are waiting to be read.
+
+    \sa bytesToWrite(), read()
+*/
+qint64 QSerialPort::bytesAvailable() const
+{
+    return QIODevice::bytesAvailable();
+}
+
+/*!
+    \reimp
+
+    Returns the number of bytes that are waiting to be written. The
+    bytes are written when control goes back to the event loop or
+    when flush() is called.
+
+    \sa bytesAvailable(), flush()
+*/
+qint64 QSerialPort::bytesToWrite() const
+{
+    qint64 pendingBytes = QIODevice::bytesToWrite() + d_func()->urgentWriteBuffer.size();
+#if defined(Q_OS_WIN32)
+    pendingBytes += d_func()->writeChunkBuffer.size();
+#else
+    if (d_func()->ioThread)
+        pendingBytes += d_func()->ioThread->bytesToWrite();
+#endif
+    return pendingBytes;
+}
+
+/*!
+    \since 6.9
+
+    Returns the number of bytes which have been received by the driver, but
+    not yet read by QSerialPort, or \c -1 if the port is not open or the
+    number cannot be determined.
+
+    Unlike bytesAvailable(), which only counts the data already in the
+    internal read buffer, this reports the backlog queued in the driver
+    (\c FIONREAD on Unix).
+
+    \sa bytesAvailable(), kernelBytesToWrite()
+*/
+qint64 QSerialPort::kernelBytesAvailable() const
+{
+    Q_D(const QSerialPort);
+    return isOpen() ? d->queuedBytesCount(Input) : qint64(-1);
+}
+
+/*!
+    \since 6.9
+
+    Returns the number of bytes which have been passed to the driver, but
+    not yet transmitted, or \c -1 if the port is not open or the number
+    cannot be determined.
+
+    Unlike bytesToWrite(), which only counts the data still in the internal
+    write buffer, this reports the backlog queued in the driver
+    (\c TIOCOUTQ on Unix).
+
+    \sa bytesToWrite(), kernelBytesAvailable()
+*/
+qint64 QSerialPort::kernelBytesToWrite() const
+{
+    Q_D(const QSerialPort);
+    return isOpen() ? d->queuedBytesCount(Output) : qint64(-1);
+}
+
+/*!
+    \reimp
+
+    Returns \c true if a line of data can be read from the serial port;
+    otherwise returns \c false.
+
+    \sa readLine()
+*/
+bool QSerialPort::canReadLine() const
+{
+    return QIODevice::canReadLine();
+}
+
+/*!
+    \since 6.9
+
+    Returns a view on the longest contiguous block of data in the internal
+    read buffer which starts \a offset bytes after the current read position,
+    without copying or consuming it. Returns an empty view if less than
+    \a offset + 1 bytes are available.
+
+    The read buffer may consist of several blocks, so the returned view can
+    be shorter than bytesAvailable(). To iterate over all the buffered data,
+    advance \a offset by the size of each returned view. Once the data has
+    been processed, consume it with \l{QIODevice::}{skip()}:
+
+    \code
+        QByteArrayView view;
+        while (!(view = serial.readView()).isEmpty()) {
+            const qint64 parsed = parser.parse(view.data(), view.size());
+            if (parsed == 0)
+                break;
+            serial.skip(parsed);
+        }
+    \endcode
+
+    The view remains valid until data is read or skipped, the buffer is
+    cleared, or the port is closed.
+
+    \sa bytesAvailable(), QIODevice::peek()
+*/
+QByteArrayView QSerialPort::readView(qint64 offset) const
+{
+    Q_D(const QSerialPort);
+
+    if (d->transactionStarted)
+        offset += d->transactionPos;
+
+    if (offset < 0 || offset >= d->buffer.size())
+        return QByteArrayView();
+
+    qint64 length = 0;
+    const char *data = d->buffer.readPointerAtPosition(offset, length);
+    return QByteArrayView(data, length);
+}
+
+/*!
+    \since 6.9
+
+    Returns the delimiter which terminates the frames returned by
+    readFrame(), or an empty byte array if frame detection is disabled.
+
+    \sa setFrameDelimiter()
+*/
+QByteArray QSerialPort::frameDelimiter() const
+{
+    Q_D(const QSerialPort);
+    return d->frameDelimiter;
+}
+
+/*!
+    \since 6.9
+
+    Sets the \a delimiter which terminates the frames of the protocol
+    spoken over the serial port, for example \c{"\r\n"}. An empty
+    \a delimiter disables frame detection, which is the default.
+
+    While a delimiter is set, QSerialPort searches the data for it as it
+    is received, emits frameReady() whenever one or more complete frames
+    have arrived, and remembers where they end. Unlike canReadLine(), which
+    has to search the whole read buffer on each call, the received data is
+    searched only once, so a large backlog of frames can be taken out with
+    readFrame() at a constant cost per frame.
+
+    Changing the delimiter discards the positions of frames found before,
+    and searches the data which is already buffered again. The delimiter is
+    ignored while a framingProtocol() is set.
+
+    \sa frameDelimiter(), readFrame(), canReadFrame()
+*/
+void QSerialPort::setFrameDelimiter(const QByteArray &delimiter)
+{
+    Q_D(QSerialPort);
+
+    d->frameDelimiter = delimiter;
+    d->resetFraming();
+    if (!d->frameDecoder && !delimiter.isEmpty())
+        d->scanForFrames();
+}
+
+/*!
+    \since 6.9
+
+    Returns the protocol used to split the received data into frames.
+
+    \sa setFramingProtocol()
+*/
+QSerialPort::FramingProtocol QSerialPort::framingProtocol() const
+{
+    Q_D(const QSerialPort);
+    return d->framingProtocol;
+}
+
+/*!
+    \since 6.9
+
+    Sets the \a protocol used to split the received data into frames, and
+    to encode the frames passed to writeFrame(). The default is NoFraming.
+
+    With a framing protocol, each chunk of data is decoded incrementally
+    right after it has been read from the port, and frameReady() is emitted
+    whenever one or more frames have been completed. readFrame() then
+    returns the decoded payload, and drops the encoded data from the read
+    buffer. For LengthPrefixFraming, the payload is not copied before it is
+    read.
+
+    While a framing protocol is set, the frameDelimiter() is ignored.
+    Changing the protocol discards the frames found before, and decodes the
+    data which is already buffered again.
+
+    \sa framingProtocol(), setFrameLengthPrefixSize(), readFrame()
+*/
+void QSerialPort::setFramingProtocol(FramingProtocol protocol)
+{
+    Q_D(QSerialPort);
+
+    d->framingProtocol = protocol;
+    d->frameDecoder = QSerialPortFrameDecoder::create(protocol, d->frameLengthPrefixSize);
+    d->frameEncoder = QSerialPortFrameEncoder::create(protocol, d->frameLengthPrefixSize);
+    d->resetFraming();
+    if (d->frameDecoder || !d->frameDelimiter.isEmpty())
+        d->scanForFrames();
+}
+
+/*!
+    \since 6.9
+
+    Returns the size in bytes of the length which precedes each frame with
+    LengthPrefixFraming.
+
+    \sa setFrameLengthPrefixSize()
+*/
+int QSerialPort::frameLengthPrefixSize() const
+{
+    Q_D(const QSerialPort);
+    return d->frameLengthPrefixSize;
+}
+
+/*!
+    \since 6.9
+
+    Sets the size of the length which precedes each frame with
+    LengthPrefixFraming to \a bytes, which must be \c 1, \c 2 or \c 4.
+    The default is \c 2.
+
+    If the size is valid, returns \c true; otherwise returns \c false and
+    sets the UnsupportedOperationError error code.
+
+    \sa frameLengthPrefixSize(), setFramingProtocol()
+*/
+bool QSerialPort::setFrameLengthPrefixSize(int bytes)
+{
+    Q_D(QSerialPort);
+
+    if (bytes != 1 && bytes != 2 && bytes != 4) {
+        d->setError(QSerialPortErrorInfo(QSerialPort::UnsupportedOperationError,
+                                         tr("Invalid frame length prefix size")));
+        return false;
+    }
+
+    d->frameLengthPrefixSize = bytes;
+    if (d->framingProtocol == LengthPrefixFraming)
+        setFramingProtocol(LengthPrefixFraming);
+    return true;
+}
+
+/*!
+    \since 6.9
+
+    Returns \c true if a complete frame can be read with readFrame();
+    otherwise returns \c false.
+
+    \sa setFrameDelimiter(), frameReady()
+*/
+bool QSerialPort::canReadFrame() const
+{
+    Q_D(const QSerialPort);
+    return d->hasPendingFrame();
+}
+
+/*!
+    \since 6.9
+
+    Reads the next complete frame from the serial port and returns its
+    payload, without the frameDelimiter() or the encoding of the
+    framingProtocol(). Returns an empty byte array if no complete frame is
+    available; use canReadFrame() to tell it apart from an empty frame.
+
+    If the beginning of a delimited or length-prefixed frame has been
+    consumed already, for example with read(), only its remaining part is
+    returned.
+
+    \sa canReadFrame(), frameReady(), setFrameDelimiter(), setFramingProtocol()
+*/
+QByteArray QSerialPort::readFrame()
+{
+    Q_D(QSerialPort);
+
+    const qint64 readOffset = d->readStreamOffset();
+    while (!d->frames.isEmpty() && d->frames.constFirst().end <= readOffset)
+        d->frames.removeFirst();
+    if (d->frames.isEmpty())
+        return QByteArray();
+
+    const QSerialPortFrame frame = d->frames.takeFirst();
+    QByteArray payload;
+    if (frame.decoded) {
+        payload = frame.payload;
+    } else {
+        if (frame.payloadStart > readOffset)
+            skip(frame.payloadStart - readOffset);
+        payload = read(qMax(frame.payloadEnd - d->readStreamOffset(), qint64(0)));
+    }
+
+    // Drop the delimiter or the encoded data of the frame.
+    const qint64 remaining = frame.end - d->readStreamOffset();
+    if (remaining > 0)
+        skip(remaining);
+    d->updateReadBufferWatermarks();
+    return payload;
+}
+
+/*!
+    \since 6.9
+
+    Encodes \a payload as a frame of the framingProtocol() and queues it
+    for writing. With NoFraming, the frameDelimiter() is appended to the
+    payload instead.
+
+    The frame is encoded directly into the write buffer, so the payload
+    does not need to be escaped by the caller, and no temporary copy of the
+    encoded frame is made.
+
+    Returns the number of encoded bytes queued, or -1 if an error occurred.
+    The bytesWritten() signal reports the encoded bytes as well.
+
+    With UrgentPriority as \a priority, the frame is written before the
+    normal priority data still queued, but never in the middle of another
+    frame.
+
+    \note An empty payload cannot be told apart from the gap between two
+    frames with SlipFraming and HdlcFraming, so the receiver ignores it.
+
+    \sa readFrame(), setFramingProtocol(), bytesToWrite(), writeUrgent()
+*/
+qint64 QSerialPort::writeFrame(QByteArrayView payload, WritePriority priority)
+{
+    Q_D(QSerialPort);
+
+    if (!isOpen()) {
+        d->setError(QSerialPortErrorInfo(QSerialPort::NotOpenError));
+        qWarning("%s: device not open", Q_FUNC_INFO);
+        return -1;
+    }
+
+    if (!isWritable()) {
+        qWarning("%s: device not open for writing", Q_FUNC_INFO);
+        return -1;
+    }
+
+    return d->writeFrame(payload, priority);
+}
+
+/*!
+    \since 6.9
+
+    Queues \a data for writing ahead of the normal priority data, for
+    example an emergency stop or a heartbeat message which must not wait
+    behind a bulk transfer.
+
+    The urgent data is inserted at the next write boundary: the data passed
+    to a single call to write() or writeFrame() is never split by it. Only
+    the data not yet handed to the driver can be overtaken. Urgent data
+    itself is written in order, and is not held back by the write
+    coalescing window.
+
+    Returns the number of bytes queued, or -1 if an error occurred. The
+    bytesWritten() signal reports the urgent bytes as well.
+
+    \sa writeFrame(), submittedBytes(), bytesToWrite()
+*/
+qint64 QSerialPort::writeUrgent(QByteArrayView data)
+{
+    Q_D(QSerialPort);
+
+    if (!isOpen()) {
+        d->setError(QSerialPortErrorInfo(QSerialPort::NotOpenError));
+        qWarning("%s: device not open", Q_FUNC_INFO);
+        return -1;
+    }
+
+    if (!isWritable()) {
+        qWarning("%s: device not open for writing", Q_FUNC_INFO);
+        return -1;
+    }
+
+    if (data.isEmpty())
+        return 0;
+
+    d->urgentWriteBuffer.append(data.data(), data.size());
+    d->flushCoalescedWrite();
+    return data.size();
+}
+
+/*!
+    \since 6.9
+
+    Queues a frame for a 9-bit multidrop bus for writing. The frame
+    consists of the \a address byte, which is sent with mark parity, and
+    the \a payload, which is sent with space parity.
+
+    The port has to be configured with SpaceParity. The parity is switched
+    by the backend for the address byte only, once the preceding data has
+    been transmitted, instead of by calls to setParity() between the bytes.
+    The parity() property does not change.
+
+    Returns the number of bytes queued, or -1 if an error occurred. The
+    frame is never split by urgent data, see writeUrgent().
+
+    \note This function is only supported on Unix platforms.
+
+    \sa setParity(), writeFrame()
+*/
+qint64 QSerialPort::writeAddressed(quint8 address, QByteArrayView payload)
+{
+    Q_D(QSerialPort);
+
+    if (!isOpen()) {
+        d->setError(QSerialPortErrorInfo(QSerialPort::NotOpenError));
+        qWarning("%s: device not open", Q_FUNC_INFO);
+        return -1;
+    }
+
+    if (!isWritable()) {
+        qWarning("%s: device not open for writing", Q_FUNC_INFO);
+        return -1;
+    }
+
+#if defined(Q_OS_WIN32)
+    d->setError(QSerialPortErrorInfo(QSerialPort::UnsupportedOperationError,
+                                     tr("Addressed writes are unsupported")));
+    return -1;
+#else
+    if (d->parity.valueBypassingBindings() != SpaceParity) {
+        d->setError(QSerialPortErrorInfo(QSerialPort::UnsupportedOperationError,
+                                         tr("Addressed writes require space parity")));
+        return -1;
+    }
+
+    return d->writeAddressed(address, payload);
+#endif
+}
+
+/*!
+    \since 6.9
+
+    Returns the number of bytes of the given \a priority handed to the
+    driver since the port was opened.
+
+    \sa writeUrgent(), bytesToWrite()
+*/
+qint64 QSerialPort::submittedBytes(WritePriority priority) const
+{
+    Q_D(const QSerialPort);
+    return priority == UrgentPriority ? d->submittedUrgentBytes : d->submittedNormalBytes;
+}
+
+/*!
+    \class QSerialPort::ReceivedChunk
+    \inmodule QtSerialPort
+    \since 6.9
+
+    \brief The ReceivedChunk class holds a chunk of data together with the
+    time when it was read from the serial port.
+
+    \sa QSerialPort::readWithTimestamps()
+*/
+
+/*!
+    \variable QSerialPort::ReceivedChunk::data
+
+    The received bytes.
+*/
+
+/*!
+    \variable QSerialPort::ReceivedChunk::timestamp
+
+    The time when the data was read from the driver, or a default
+    constructed time point if it is unknown.
+*/
+
+/*!
+    \class QSerialPort::ReceiveError
+    \inmodule QtSerialPort
+    \since 6.9
+
+    \brief The ReceiveError class describes a character which was received
+    with an error.
+
+    \sa QSerialPort::receiveErrors()
+*/
+
+/*!
+    \variable QSerialPort::ReceiveError::offset
+
+    The position of the character, relative to the next byte to be read.
+*/
+
+/*!
+    \variable QSerialPort::ReceiveError::type
+
+    The kind of error.
+*/
+
+/*!
+    \since 6.9
+
+    Returns \c true if the characters received with an error are marked
+    by the driver and reported by receiveErrors(); otherwise returns
+    \c false.
+
+    \sa setReceiveErrorMarkingEnabled()
+*/
+bool QSerialPort::isReceiveErrorMarkingEnabled() const
+{
+    Q_D(const QSerialPort);
+    return d->receiveErrorMarking;
+}
+
+/*!
+    \since 6.9
+
+    If \a enable is \c true, the driver is configured to mark the characters
+    received with a parity or framing error, and the break conditions,
+    instead of dropping them. This is disabled by default.
+
+    The escape sequences inserted by the driver are removed right after the
+    data has been read, so the read buffer only holds the received
+    characters, including the ones with an error. The errors are reported
+    separately by receiveErrors(). Chunks of data without any escape
+    sequence are passed through as is.
+
+    On a 9-bit multidrop bus, with the port configured for SpaceParity,
+    this reports the address bytes, which are sent with mark parity, as
+    parity errors.
+
+    If the setting is successful or set before opening the port, returns
+    \c true; otherwise returns \c false and sets an error code.
+
+    \note This setting is only supported on Unix platforms, through the
+    \c PARMRK flag of the terminal.
+
+    \sa receiveErrors(), setParity()
+*/
+bool QSerialPort::setReceiveErrorMarkingEnabled(bool enable)
+{
+    Q_D(QSerialPort);
+
+    if (!isOpen() || d->setReceiveErrorMarking(enable)) {
+        d->receiveErrorMarking = enable;
+        d->errorMarkState = QSerialPortPrivate::NoErrorMark;
+        return true;
+    }
+    return false;
+}
+
+/*!
+    \since 6.9
+
+    Returns the characters with an error among the data which has not been
+    read yet. The offset of each of them is relative to the next byte which
+    read() returns, so it can be used as an index into the data returned by
+    readAll().
+
+    \sa setReceiveErrorMarkingEnabled()
+*/
+QList<QSerialPort::ReceiveError> QSerialPort::receiveErrors() const
+{
+    Q_D(const QSerialPort);
+
+    QList<ReceiveError> errors;
+    const qint64 readOffset = d->readStreamOffset();
+    for (const ReceiveError &error : d->receiveErrors) {
+        if (error.offset >= readOffset)
+            errors.append({ error.offset - readOffset, error.type });
+    }
+    return errors;
+}
+
+/*!
+    \since 6.9
+
+    Returns \c true if the time when each chunk of data is read from the
+    driver is recorded; otherwise returns \c false.
+
+    \sa setReceiveTimestampsEnabled()
+*/
+bool QSerialPort::isReceiveTimestampsEnabled() const
+{
+    Q_D(const QSerialPort);
+    return d->receiveTimestampsEnabled;
+}
+
+/*!
+    \since 6.9
+
+    If \a enable is \c true, the time when each chunk of data is read from
+    the driver is recorded, so that readWithTimestamps() can tell when the
+    data arrived. This is disabled by default.
+
+    The timestamps are taken from the monotonic std::chrono::steady_clock
+    right after each read, before any signal is emitted. Comparing them with
+    the time when the data is processed reveals how long it waited in the
+    event loop.
+
+    \note On Windows, the timestamp is taken when the asynchronous read
+    operation completes.
+
+    \sa isReceiveTimestampsEnabled(), readWithTimestamps()
+*/
+void QSerialPort::setReceiveTimestampsEnabled(bool enable)
+{
+    Q_D(QSerialPort);
+    d->receiveTimestampsEnabled = enable;
+    if (!enable)
+        d->receiveTimestamps.clear();
+}
+
+/*!
+    \since 6.9
+
+    Reads all the available data, split into the chunks in which it was
+    read from the driver, each with the time when it was read.
+
+    Data for which no timestamp was recorded, for example because it was
+    received before setReceiveTimestampsEnabled() was called, is returned
+    as the last chunk with a default constructed timestamp.
+
+    \sa setReceiveTimestampsEnabled(), readAll()
+*/
+QList<QSerialPort::ReceivedChunk> QSerialPort::readWithTimestamps()
+{
+    Q_D(QSerialPort);
+
+    QList<ReceivedChunk> chunks;
+    const auto timestamps = std::exchange(d->receiveTimestamps, {});
+    qint64 readOffset = d->readStreamOffset();
+    for (const auto &timestamp : timestamps) {
+        if (timestamp.end <= readOffset)
+            continue;
+        chunks.append({ read(timestamp.end - readOffset), timestamp.time });
+        readOffset = d->readStreamOffset();
+    }
+
+    if (bytesAvailable() > 0)
+        chunks.append({ readAll(), {} });
+    d->updateReadBufferWatermarks();
+    return chunks;
+}
+
+/*!
+    \fn void QSerialPort::frameReady()
+    \since 6.9
+
+    This signal is emitted once every time one or more complete frames,
+    terminated by the frameDelimiter() or decoded with the
+    framingProtocol(), have been received. It is emitted
+    right after the corresponding readyRead() signal, regardless of the
+    readyReadThreshold().
+
+    \sa readFrame(), setFrameDelimiter()
+*/
+
+/*!
+    \reimp
+
+    This function blocks until new data is available for reading and the
+    \l{QIODevice::}{readyRead()} signal has been emitted. The function
+    will timeout after \a msecs milliseconds; the default timeout is
+    30000 milliseconds. If \a msecs is -1, this function will not time out.
+
+    The function returns \c true if the readyRead() signal is emitted and
+    there is new data available for reading; otherwise it returns \c false
+    (if an error occurred or the operation timed out).
+
+    \sa waitForBytesWritten()
+*/
+bool QSerialPort::waitForReadyRead(int msecs)
+{
+    Q_D(QSerialPort);
+    return d->waitForReadyRead(msecs);
+}
+
+/*!
+    \fn Handle QSerialPort::handle() const
+    \since 5.2
+
+    If the platform is supported and the serial port is open, returns the native
+    serial port handle; otherwise returns \c -1.
+
+    \warning This function is for expert use only; use it at your own risk.
+    Furthermore, this function carries no compatibility promise between minor
+    Qt releases.
+*/
+
+/*!
+    \reimp
+
+    This function blocks until at least one byte has been written to the serial
+    port and the \l{QIODevice::}{bytesWritten()} signal has been emitted. The
+    function will timeout after \a msecs milliseconds; the default timeout is
+    30000 milliseconds. If \a msecs is -1, this function will not time out.
+
+    The function returns \c true if the bytesWritten() signal is emitted; otherwise
+    it returns \c false (if an error occurred or the operation timed out).
+*/
+bool QSerialPort::waitForBytesWritten(int msecs)
+{
+    Q_D(QSerialPort);
+    return d->waitForBytesWritten(msecs);
+}
+
+/*!
+    \since 6.9
+
+    This function blocks until all the written data has left the transmitter
+    of the serial port and the transmitComplete() signal has been emitted.
+    The function will timeout after \a msecs milliseconds; the default
+    timeout is 30000 milliseconds. If \a msecs is -1, this function will not
+    time out.
+
+    The data still in the write buffer is written first. While waiting for
+    the driver to transmit its queued data, the calling thread sleeps for
+    the time the data takes on the wire at the current baud rate.
+
+    The function returns \c true if the transmitComplete() signal is
+    emitted; otherwise it returns \c false (if an error occurred or the
+    operation timed out).
+
+    \sa transmitComplete(), waitForBytesWritten()
+*/
+bool QSerialPort::waitForTransmitComplete(int msecs)
+{
+    Q_D(QSerialPort);
+
+    if (!isOpen()) {
+        d->setError(QSerialPortErrorInfo(QSerialPort::NotOpenError));
+        qWarning("%s: device not open", Q_FUNC_INFO);
+        return false;
+    }
+
+    return d->waitForTransmitComplete(msecs);
+}
+
+/*!
+    \property QSerialPort::breakEnabled
+    \since 5.5
+    \brief the state of the transmission line in break
+
+    Returns \c true on success, \c false otherwise.
+    If the flag is \c true then the transmission line is in break state;
+    otherwise is in non-break state.
+
+    \note The serial port has to be open before trying to set or get this
+    property; otherwise returns \c false and sets the NotOpenError error code.
+    This is a bit unusual as opposed to the regular Qt property settings of
+    a class. However, this is a special use case since the property is set
+    through the interaction with the kernel and hardware. Hence, the two
+    scenarios cannot be completely compared to each other.
+*/
+bool QSerialPort::setBreakEnabled(bool set)
+{
+    Q_D(QSerialPort);
+    d->isBreakEnabled.removeBindingUnlessInWrapper();
+    const auto currentSet = d->isBreakEnabled.valueBypassingBindings();
+    if (isOpen()) {
+        if (d->setBreakEnabled(set)) {
+            d->isBreakEnabled.setValueBypassingBindings(set);
+            if (currentSet != set) {
+                d->isBreakEnabled.notify();
+                emit breakEnabledChanged(set);
+            }
+            return true;
+        }
+    } else {
+        d->setError(QSerialPortErrorInfo(QSerialPort::NotOpenError));
+        qWarning("%s: device not open", Q_FUNC_INFO);
+    }
+    return false;
+}
+
+bool QSerialPort::isBreakEnabled() const
+{
+    Q_D(const QSerialPort);
+    return d->isBreakEnabled;
+}
+
+QBindable<bool> QSerialPort::bindableIsBreakEnabled()
+{
+    return &d_func()->isBreakEnabled;
+}
+
+/*!
+    \reimp
+
+    \omit
+    This function does not really read anything, as we use QIODevicePrivate's
+    buffer. The buffer will be read inside of QIODevice before this
+    method will be called.
+    \endomit
+*/
+qint64 QSerialPort::readData(char *data, qint64 maxSize)
 {
     Q_UNUSED(data);
     Q_UNUSED(maxSize);
 
+    Q_D(QSerialPort);
+
+    d->updateReadBufferWatermarks();
+
     // In any case we need to start the notifications if they were
     // disabled by the read handler. If enabled, next call does nothing.
-    d_func()->startAsyncRead();
+    d->startAsyncRead();
 
     // return 0 indicating there may be more data in the future
     return qint64(0);
@@ -10,6 +10,8 @@
 
 #include <QtSerialPort/qserialportglobal.h>
 
+#include <chrono>
+
 QT_BEGIN_NAMESPACE
 
 class QSerialPortInfo;
@@ -94,6 +96,33 @@ public:
     };
     Q_ENUM(FlowControl)
 
+    enum FramingProtocol {
+        NoFraming,
+        SlipFraming,
+        CobsFraming,
+        HdlcFraming,
+        LengthPrefixFraming
+    };
+    Q_ENUM(FramingProtocol)
+
+    enum ReadBufferPolicy {
+        PauseReading,
+        DiscardOldestData
+    };
+    Q_ENUM(ReadBufferPolicy)
+
+    enum WritePriority {
+        NormalPriority,
+        UrgentPriority
+    };
+    Q_ENUM(WritePriority)
+
+    enum ReceiveErrorType {
+        ParityOrFramingError,
+        BreakError
+    };
+    Q_ENUM(ReceiveErrorType)
+
     enum PinoutSignal {
         NoSignal = 0x00,
         DataTerminalReadySignal = 0x04,
@@ -123,6 +152,28 @@ public:
     };
     Q_ENUM(SerialPortError)
 
+    struct ReceivedChunk
+    {
+        QByteArray data;
+        std::chrono::steady_clock::time_point timestamp;
+    };
+
+    struct ReceiveError
+    {
+        qint64 offset;
+        ReceiveErrorType type;
+    };
+
+    struct Rs485Settings
+    {
+        bool enabled = false;
+        bool rtsOnSend = true;
+        bool rtsAfterSend = false;
+        bool receiveDuringTransmit = false;
+        std::chrono::milliseconds delayBeforeSend{0};
+        std::chrono::milliseconds delayAfterSend{0};
+    };
+
     explicit QSerialPort(QObject *parent = nullptr);
     explicit QSerialPort(const QString &name, QObject *parent = nullptr);
     explicit QSerialPort(const QSerialPortInfo &info, QObject *parent = nullptr);
@@ -158,6 +209,15 @@ public:
     FlowControl flowControl() const;
     QBindable<FlowControl> bindableFlowControl();
 
+    bool setMinimumReadSize(int bytes);
+    int minimumReadSize() const;
+
+    void setInterByteTimeout(std::chrono::milliseconds timeout);
+    std::chrono::milliseconds interByteTimeout() const;
+
+    bool setRs485Settings(const Rs485Settings &settings);
+    Rs485Settings rs485Settings() const;
+
     bool setDataTerminalReady(bool set);
     bool isDataTerminalReady();
 
@@ -176,14 +236,85 @@ public:
     qint64 readBufferSize() const;
     void setReadBufferSize(qint64 size);
 
+    ReadBufferPolicy readBufferPolicy() const;
+    void setReadBufferPolicy(ReadBufferPolicy policy);
+    qint64 discardedBytes() const;
+
+    qint64 readBufferHighWatermark() const;
+    void setReadBufferHighWatermark(qint64 bytes);
+    qint64 readBufferLowWatermark() const;
+    void setReadBufferLowWatermark(qint64 bytes);
+    std::chrono::nanoseconds readPausedTime() const;
+
+    bool isInputThrottlingEnabled() const;
+    void setInputThrottlingEnabled(bool enable);
+    bool isInputThrottled() const;
+
+    qint64 readChunkSize() const;
+    void setReadChunkSize(qint64 size);
+
+    bool isAdaptiveReadChunkSizeEnabled() const;
+    void setAdaptiveReadChunkSizeEnabled(bool enable);
+
+    bool isPreallocatedReadBufferEnabled() const;
+    void setPreallocatedReadBufferEnabled(bool enable);
+
+    bool isIoThreadEnabled() const;
+    void setIoThreadEnabled(bool enable);
+
+    qint64 readDrainBudget() const;
+    void setReadDrainBudget(qint64 bytes);
+
+    qint64 readyReadThreshold() const;
+    void setReadyReadThreshold(qint64 bytes);
+
+    std::chrono::microseconds readyReadLatency() const;
+    void setReadyReadLatency(std::chrono::microseconds latency);
+
+    bool isImmediateWriteEnabled() const;
+    void setImmediateWriteEnabled(bool enable);
+
+    std::chrono::microseconds writeCoalescingDelay() const;
+    void setWriteCoalescingDelay(std::chrono::microseconds delay);
+    qint64 writeCoalescingSize() const;
+    void setWriteCoalescingSize(qint64 bytes);
+    qint64 coalescedWrites() const;
+
     bool isSequential() const override;
 
     qint64 bytesAvailable() const override;
     qint64 bytesToWrite() const override;
     bool canReadLine() const override;
 
+    qint64 kernelBytesAvailable() const;
+    qint64 kernelBytesToWrite() const;
+
+    QByteArrayView readView(qint64 offset = 0) const;
+
+    QByteArray frameDelimiter() const;
+    void setFrameDelimiter(const QByteArray &delimiter);
+    FramingProtocol framingProtocol() const;
+    void setFramingProtocol(FramingProtocol protocol);
+    int frameLengthPrefixSize() const;
+    bool setFrameLengthPrefixSize(int bytes);
+    bool canReadFrame() const;
+    QByteArray readFrame();
+    qint64 writeFrame(QByteArrayView payload, WritePriority priority = NormalPriority);
+    qint64 writeUrgent(QByteArrayView data);
+    qint64 writeAddressed(quint8 address, QByteArrayView payload);
+    qint64 submittedBytes(WritePriority priority) const;
+
+    bool isReceiveTimestampsEnabled() const;
+    void setReceiveTimestampsEnabled(bool enable);
+    QList<ReceivedChunk> readWithTimestamps();
+
+    bool isReceiveErrorMarkingEnabled() const;
+    bool setReceiveErrorMarkingEnabled(bool enable);
+    QList<ReceiveError> receiveErrors() const;
+
     bool waitForReadyRead(int msecs = 30000) override;
     bool waitForBytesWritten(int msecs = 30000) override;
+    bool waitForTransmitComplete(int msecs = 30000);
 
     bool setBreakEnabled(bool set = true);
     bool isBreakEnabled() const;
@@ -201,6 +332,10 @@ Q_SIGNALS:
     void requestToSendChanged(bool set);
     void errorOccurred(QSerialPort::SerialPortError error);
     void breakEnabledChanged(bool set);
+    void frameReady();
+    void readBufferHighWater();
+    void readBufferLowWater();
+    void transmitComplete();
 
 protected:
     qint64 readData(char *data, qint64 maxSize) override;
@@ -18,12 +18,14 @@
 //
 
 #include "qserialport.h"
+#include "qserialportframing_p.h"
 
 #include <qdeadlinetimer.h>
 
 #include <private/qiodevice_p.h>
 #include <private/qproperty_p.h>
 
+#include <chrono>
 #include <memory>
 
 #if defined(Q_OS_WIN32)
@@ -34,6 +36,7 @@
 #  include <QtCore/qstringlist.h>
 #  include <limits.h>
 #  include <termios.h>
+#  include "qserialportiothread_p.h"
 #  ifdef Q_OS_ANDROID
 struct serial_struct {
     int     type;
@@ -69,10 +72,15 @@ struct serial_struct {
 #define QSERIALPORT_BUFFERSIZE 32768
 #endif
 
+#ifndef QSERIALPORT_MIN_READ_CHUNKSIZE
+#define QSERIALPORT_MIN_READ_CHUNKSIZE 256
+#endif
+
 QT_BEGIN_NAMESPACE
 
 class QWinOverlappedIoNotifier;
 class QTimer;
+class QChronoTimer;
 class QSocketNotifier;
 
 #if defined(Q_OS_UNIX)
@@ -102,6 +110,7 @@ public:
 
     bool setDataTerminalReady(bool set);
     bool setRequestToSend(bool set);
+    bool setInputFlowStopped(bool stopped);
 
     bool flush();
     bool clear(QSerialPort::Directions directions);
@@ -111,6 +120,7 @@ public:
 
     bool waitForReadyRead(int msec);
     bool waitForBytesWritten(int msec);
+    bool waitForTransmitComplete(int msec);
 
     bool setBaudRate();
     bool setBaudRate(qint32 baudRate, QSerialPort::Directions directions);
@@ -118,18 +128,139 @@ public:
     bool setParity(QSerialPort::Parity parity);
     bool setStopBits(QSerialPort::StopBits stopBits);
     bool setFlowControl(QSerialPort::FlowControl flowControl);
+    bool setMinimumReadSize(int bytes);
+    bool setRs485(const QSerialPort::Rs485Settings &settings);
+    bool setReceiveErrorMarking(bool enable);
+
+    qint64 queuedBytesCount(QSerialPort::Direction direction) const;
+    qint64 transmitterQueueSize() const;
+    std::chrono::microseconds transmitTime(qint64 bytes) const;
+    bool isWriteInProgress() const;
+    void scheduleTransmitCompleteCheck();
+    void checkTransmitComplete();
 
     QSerialPortErrorInfo getSystemError(int systemErrorCode = -1) const;
 
     void setError(const QSerialPortErrorInfo &errorInfo);
 
     qint64 writeData(const char *data, qint64 maxSize);
+    qint64 writeFrame(QByteArrayView payload, QSerialPort::WritePriority priority);
+    qint64 writeAddressed(quint8 address, QByteArrayView payload);
+    template <typename Buffer>
+    qint64 appendFrame(Buffer &buffer, QByteArrayView payload);
+    void scheduleAsyncWrite();
+    void coalesceWrite();
+    void flushCoalescedWrite();
+    void recordWriteSubmission();
+
+    bool hasPendingWriteData() const;
+    qint64 pendingWriteUnitSize() const;
+    bool isUrgentWriteDue() const;
+    void recordWriteUnit();
+    void advanceNormalWriteLane(qint64 bytes);
+    void consumeWriteLanes(qint64 bytes);
+    void clearWriteLanes();
 
     bool initialize(QIODevice::OpenMode mode);
 
     static QList<qint32> standardBaudRates();
 
+    qint64 nextReadChunkSize() const;
+    void updateReadChunkSize(qint64 requestedSize, qint64 readBytes);
+
+    void processReceivedData(qint64 bytes);
+    void emitReadyRead();
+    void flushReadyRead();
+
+    void recordReceiveTimestamp(qint64 chunkEnd);
+    qint64 decodeErrorMarks(char *data, qint64 size, qint64 offset);
+    void updateReadBufferWatermarks();
+    void scheduleReadBufferWatermarkCheck();
+    void setReadPaused(bool paused);
+    void setInputThrottled(bool throttled);
+    bool isDiscardingOldestData() const;
+    void discardOldestData(qint64 bytes);
+
+    qint64 readStreamOffset() const;
+    void resetFraming();
+    bool scanForFrames();
+    bool hasPendingFrame() const;
+    void emitFrameReady();
+
     qint64 readBufferMaxSize = 0;
+    qint64 readBufferHighWatermark = 0;
+    qint64 readBufferLowWatermark = 0;
+    bool readBufferAboveHighWatermark = false;
+    QChronoTimer *readBufferWatermarkTimer = nullptr;
+    QSerialPort::ReadBufferPolicy readBufferPolicy = QSerialPort::PauseReading;
+    qint64 discardedBytes = 0;
+    bool inputThrottlingEnabled = false;
+    bool inputThrottled = false;
+    bool readPaused = false;
+    std::chrono::steady_clock::time_point readPausedSince;
+    std::chrono::nanoseconds readPausedTime{0};
+    qint64 readDrainBudget = 0;
+    qint64 readyReadThreshold = 0;
+    std::chrono::microseconds readyReadLatency{0};
+    QChronoTimer *readyReadTimer = nullptr;
+    bool emittedReadyRead = false;
+    qint64 unreportedReadBytes = 0;
+    qint64 currentReadChunkSize = QSERIALPORT_MIN_READ_CHUNKSIZE;
+    int shortReadCount = 0;
+    bool adaptiveReadChunkSize = false;
+    bool preallocatedReadBuffer = false;
+    bool ioThreadEnabled = false;
+    bool immediateWrite = false;
+    std::chrono::microseconds writeCoalescingDelay{0};
+    qint64 writeCoalescingSize = 0;
+    QChronoTimer *writeCoalescingTimer = nullptr;
+    qint64 queuedWriteCount = 0;
+    qint64 coalescedWrites = 0;
+
+    // Urgent data bypasses the normal priority data in the write buffer,
+    // but only at the end of a write, tracked by the offsets in the stream
+    // of normal priority bytes submitted to the driver.
+    QRingBuffer urgentWriteBuffer;
+    QList<qint64> writeUnitEnds;
+    qint64 writeUnitStart = 0;
+    qint64 submittedNormalBytes = 0;
+    qint64 submittedUrgentBytes = 0;
+    // Offsets of the address bytes of multidrop frames, in the same stream.
+    QList<qint64> addressOffsets;
+
+    QChronoTimer *transmitCompleteTimer = nullptr;
+
+    // Offsets in the stream of received bytes, independent of the
+    // data consumed from the read buffer.
+    qint64 receivedBytesTotal = 0;
+    QByteArray frameDelimiter;
+    QList<QSerialPortFrame> frames;
+    qint64 frameScanOffset = 0;
+    qint64 lastFrameEnd = 0;
+    QSerialPort::FramingProtocol framingProtocol = QSerialPort::NoFraming;
+    int frameLengthPrefixSize = 2;
+    std::unique_ptr<QSerialPortFrameDecoder> frameDecoder;
+    std::unique_ptr<QSerialPortFrameEncoder> frameEncoder;
+    bool emittedFrameReady = false;
+
+    struct ReceiveTimestamp
+    {
+        qint64 end;
+        std::chrono::steady_clock::time_point time;
+    };
+    QList<ReceiveTimestamp> receiveTimestamps;
+    bool receiveTimestampsEnabled = false;
+
+    // Position in a PARMRK escape sequence split across two reads.
+    enum ErrorMarkState {
+        NoErrorMark,
+        ErrorMarkEscape,
+        ErrorMarkCharacter
+    };
+    ErrorMarkState errorMarkState = NoErrorMark;
+    // The offsets count the decoded bytes received since the port was opened.
+    QList<QSerialPort::ReceiveError> receiveErrors;
+    bool receiveErrorMarking = false;
 
     void setBindableError(QSerialPort::SerialPortError error)
     { setError(error); }
@@ -162,6 +293,10 @@ public:
 
     bool settingsRestoredOnClose = true;
 
+    int minimumReadSize = 0;
+    QSerialPort::Rs485Settings rs485Settings;
+    std::chrono::milliseconds interByteTimeout{0};
+
     bool setBindableBreakEnabled(bool isBreakEnabled)
     { return q_func()->setBreakEnabled(isBreakEnabled); }
     Q_OBJECT_COMPAT_PROPERTY_WITH_ARGS(QSerialPortPrivate, bool, isBreakEnabled,
@@ -175,8 +310,6 @@ public:
     bool getDcb(DCB *dcb);
     OVERLAPPED *waitForNotified(QDeadlineTimer deadline);
 
-    qint64 queuedBytesCount(QSerialPort::Direction direction) const;
-
     bool completeAsyncCommunication(qint64 bytesTransferred);
     bool completeAsyncRead(qint64 bytesTransferred);
     bool completeAsyncWrite(qint64 bytesTransferred);
@@ -185,13 +318,14 @@ public:
     bool _q_startAsyncWrite();
     void _q_notified(DWORD numberOfBytes, DWORD errorCode, OVERLAPPED *overlapped);
 
-    void emitReadyRead();
 
     DCB restoredDcb;
     COMMTIMEOUTS currentCommTimeouts;
     COMMTIMEOUTS restoredCommTimeouts;
     HANDLE handle = INVALID_HANDLE_VALUE;
     QByteArray readChunkBuffer;
+    qint64 requestedReadSize = 0;
+    qint64 completedReadSize = 0;
     QByteArray writeChunkBuffer;
     bool communicationStarted = false;
     bool writeStarted = false;
@@ -222,7 +356,21 @@ public:
                             bool checkRead, bool checkWrite,
                             int msecs);
 
+    bool startIoThread(QIODevice::OpenMode mode);
+    void ioThreadNotification();
+    bool waitForIoThread(bool *notified, bool *selectForWrite, int msecs);
+    bool isDirectWriteRequired() const;
+    bool startIoThreadWrite();
+    qint64 writeBufferToIoThread();
+    qint64 takeIoThreadWrites();
+
     qint64 readFromPort(char *data, qint64 maxSize);
+    qint64 writeBufferToPort();
+    qint64 writeAddressedToPort();
+    void scheduleAddressParitySwitch(qint64 queuedBytes);
+    bool isAddressParitySwitchPending() const;
+    bool waitForAddressParitySwitch(int msecs);
+    bool setAddressParity(bool enable, bool drain);
     qint64 writeToPort(const char *data, qint64 maxSize);
 
 #ifndef CMSPAR
@@ -234,20 +382,34 @@ public:
     bool completeAsyncWrite();
 
     struct termios restoredTermios;
+#if defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID)
+    struct serial_rs485 restoredRs485;
+#endif
+    bool restoredRs485Saved = false;
     int descriptor = -1;
 
+    QByteArray readScratchBuffer;
+
     QSocketNotifier *readNotifier = nullptr;
     QSocketNotifier *writeNotifier = nullptr;
 
+    // While the I/O thread owns the descriptor, the notifications come
+    // through its pipe instead, and the notifiers above are only used
+    // for the writes which are left to this thread.
+    std::unique_ptr<QSerialPortIoThread> ioThread;
+    QSocketNotifier *ioThreadNotifier = nullptr;
+    bool ioThreadReadEnabled = false;
+
     bool readPortNotifierCalled = false;
     bool readPortNotifierState = false;
     bool readPortNotifierStateSet = false;
 
-    bool emittedReadyRead = false;
     bool emittedBytesWritten = false;
 
     qint64 pendingBytesWritten = 0;
     bool writeSequenceStarted = false;
+    bool addressParityActive = false;
+    QChronoTimer *addressParityTimer = nullptr;
 
     std::unique_ptr<QLockFile> lockFileScopedPointer;
 
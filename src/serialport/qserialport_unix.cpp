@@ -6,18 +6,23 @@
 #include "qserialport_p.h"
 #include "qserialportinfo_p.h"
 
+#include <QtCore/qchronotimer.h>
 #include <QtCore/qdeadlinetimer.h>
 #include <QtCore/qelapsedtimer.h>
 #include <QtCore/qmap.h>
 #include <QtCore/qsocketnotifier.h>
 #include <QtCore/qstandardpaths.h>
+#include <QtCore/qthread.h>
+#include <QtCore/qvarlengtharray.h>
 
 #include <private/qcore_unix_p.h>
 
 #include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
 #include <sys/ioctl.h>
 #include <sys/time.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #ifdef Q_OS_MACOS
@@ -157,6 +162,29 @@ private:
     QSerialPortPrivate * const dptr;
 };
 
+class IoThreadNotifier : public QSocketNotifier
+{
+public:
+    explicit IoThreadNotifier(QSerialPortPrivate *d, QObject *parent)
+        : QSocketNotifier(d->ioThread->notificationDescriptor(), QSocketNotifier::Read, parent)
+        , dptr(d)
+    {
+    }
+
+protected:
+    bool event(QEvent *e) override
+    {
+        if (e->type() == QEvent::SockAct) {
+            dptr->ioThreadNotification();
+            return true;
+        }
+        return QSocketNotifier::event(e);
+    }
+
+private:
+    QSerialPortPrivate * const dptr;
+};
+
 static inline void qt_set_common_props(termios *tio, QIODevice::OpenMode m)
 {
 #ifdef Q_OS_SOLARIS
@@ -177,6 +205,15 @@ static inline void qt_set_common_props(termios *tio, QIODevice::OpenMode m)
         tio->c_cflag |= CREAD;
 }
 
+static inline void qt_set_minimum_read_size(termios *tio, int bytes)
+{
+    // VTIME is ignored for descriptors in non-blocking mode, and if it
+    // is set, poll() reports the descriptor as readable on the first
+    // byte, which would defeat the batching.
+    tio->c_cc[VTIME] = 0;
+    tio->c_cc[VMIN] = cc_t(bytes);
+}
+
 static inline void qt_set_databits(termios *tio, QSerialPort::DataBits databits)
 {
     tio->c_cflag &= ~CSIZE;
@@ -234,6 +271,17 @@ static inline void qt_set_parity(termios *tio, QSerialPort::Parity parity)
     }
 }
 
+static inline void qt_set_error_marking(termios *tio, bool enable)
+{
+    if (!enable)
+        return;
+
+    // Pass the characters with an error, and the breaks, as escape
+    // sequences instead of dropping them.
+    tio->c_iflag |= PARMRK | INPCK;
+    tio->c_iflag &= ~(IGNPAR | ISTRIP | IGNBRK | BRKINT);
+}
+
 static inline void qt_set_stopbits(termios *tio, QSerialPort::StopBits stopbits)
 {
     switch (stopbits) {
@@ -316,14 +364,32 @@ bool QSerialPortPrivate::open(QIODevice::OpenMode mode)
 
     lockFileScopedPointer = std::move(newLockFileScopedPointer);
 
+    if (preallocatedReadBuffer && (mode & QIODevice::ReadOnly))
+        readScratchBuffer = QByteArray(readBufferChunkSize, Qt::Uninitialized);
+
     return true;
 }
 
 void QSerialPortPrivate::close()
 {
+    // The I/O thread must not write anything with the restored settings.
+    delete ioThreadNotifier;
+    ioThreadNotifier = nullptr;
+    ioThread.reset();
+    ioThreadReadEnabled = false;
+
+    // Otherwise the peer may be left waiting for XON, or for RTS.
+    setInputThrottled(false);
+
     if (settingsRestoredOnClose)
         ::tcsetattr(descriptor, TCSANOW, &restoredTermios);
 
+#if defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID) && defined(TIOCSRS485)
+    if (settingsRestoredOnClose && restoredRs485Saved)
+        ::ioctl(descriptor, TIOCSRS485, &restoredRs485);
+#endif
+    restoredRs485Saved = false;
+
 #ifdef TIOCNXCL
     ::ioctl(descriptor, TIOCNXCL);
 #endif
@@ -338,9 +404,14 @@ void QSerialPortPrivate::close()
 
     lockFileScopedPointer.reset(nullptr);
 
+    readScratchBuffer.clear();
+
     descriptor = -1;
     pendingBytesWritten = 0;
     writeSequenceStarted = false;
+    addressParityActive = false;
+    if (addressParityTimer)
+        addressParityTimer->stop();
 }
 
 QSerialPort::PinoutSignals QSerialPortPrivate::pinoutSignals()
@@ -422,6 +493,17 @@ bool QSerialPortPrivate::setRequestToSend(bool set)
     return true;
 }
 
+bool QSerialPortPrivate::setInputFlowStopped(bool stopped)
+{
+    // Transmits a STOP or START character to the peer
+    if (::tcflow(descriptor, stopped ? TCIOFF : TCION) == -1) {
+        setError(getSystemError());
+        return false;
+    }
+
+    return true;
+}
+
 bool QSerialPortPrivate::flush()
 {
     return completeAsyncWrite();
@@ -429,12 +511,20 @@ bool QSerialPortPrivate::flush()
 
 bool QSerialPortPrivate::clear(QSerialPort::Directions directions)
 {
+    // Before the flush, so that the I/O thread does not write any of
+    // the discarded data afterwards.
+    if (ioThread && (directions & QSerialPort::Output))
+        ioThread->discardWriteData();
+
     if (::tcflush(descriptor, (directions == QSerialPort::AllDirections)
                      ? TCIOFLUSH : (directions & QSerialPort::Input) ? TCIFLUSH : TCOFLUSH) == -1) {
         setError(getSystemError());
         return false;
     }
 
+    if (ioThread && (directions & QSerialPort::Input))
+        ioThread->discardReadData();
+
     return true;
 }
 
@@ -463,10 +553,52 @@ bool QSerialPortPrivate::waitForReadyRead(int msecs)
     QElapsedTimer stopWatch;
     stopWatch.start();
 
+    if (ioThread) {
+        if (!startAsyncWrite())
+            return false;
+
+        do {
+            // The rest of the frame is only written once the parity is switched.
+            if (isAddressParitySwitchPending()) {
+                if (!waitForAddressParitySwitch(
+                            qt_subtract_from_timeout(msecs, stopWatch.elapsed()))) {
+                    return false;
+                }
+                continue;
+            }
+
+            bool notified = false;
+            bool readyToWrite = false;
+            if (!waitForIoThread(&notified, &readyToWrite,
+                                 qt_subtract_from_timeout(msecs, stopWatch.elapsed()))) {
+                return false;
+            }
+
+            if (notified) {
+                const qint64 written = takeIoThreadWrites();
+                if (written < 0 || (written > 0 && !completeAsyncWrite()))
+                    return false;
+                if (ioThread->hasReadData())
+                    return readNotification();
+            }
+
+            if (readyToWrite && !completeAsyncWrite())
+                return false;
+        } while (msecs == -1 || qt_subtract_from_timeout(msecs, stopWatch.elapsed()) > 0);
+        return false;
+    }
+
     do {
+        // The rest of the frame is only written once the parity is switched.
+        if (isAddressParitySwitchPending()) {
+            if (!waitForAddressParitySwitch(qt_subtract_from_timeout(msecs, stopWatch.elapsed())))
+                return false;
+            continue;
+        }
+
         bool readyToRead = false;
         bool readyToWrite = false;
-        if (!waitForReadOrWrite(&readyToRead, &readyToWrite, true, !writeBuffer.isEmpty(),
+        if (!waitForReadOrWrite(&readyToRead, &readyToWrite, true, hasPendingWriteData(),
                                 qt_subtract_from_timeout(msecs, stopWatch.elapsed()))) {
             return false;
         }
@@ -482,17 +614,64 @@ bool QSerialPortPrivate::waitForReadyRead(int msecs)
 
 bool QSerialPortPrivate::waitForBytesWritten(int msecs)
 {
-    if (writeBuffer.isEmpty() && pendingBytesWritten <= 0)
+    if (ioThread && !hasPendingWriteData() && ioThread->bytesToWrite() == 0
+            && !writeSequenceStarted) {
+        return false;
+    }
+    if (!ioThread && !hasPendingWriteData() && pendingBytesWritten <= 0)
         return false;
 
     QElapsedTimer stopWatch;
     stopWatch.start();
 
+    if (ioThread) {
+        if (!startAsyncWrite())
+            return false;
+
+        for (;;) {
+            if (isAddressParitySwitchPending()) {
+                if (!waitForAddressParitySwitch(
+                            qt_subtract_from_timeout(msecs, stopWatch.elapsed()))) {
+                    return false;
+                }
+                continue;
+            }
+
+            bool notified = false;
+            bool readyToWrite = false;
+            if (!waitForIoThread(&notified, &readyToWrite,
+                                 qt_subtract_from_timeout(msecs, stopWatch.elapsed()))) {
+                return false;
+            }
+
+            if (notified) {
+                if (q_func()->isReadable() && ioThread->hasReadData() && !readNotification())
+                    return false;
+
+                const qint64 written = takeIoThreadWrites();
+                if (written < 0)
+                    return false;
+                if (written > 0)
+                    return completeAsyncWrite();
+            }
+
+            if (readyToWrite)
+                return completeAsyncWrite();
+        }
+    }
+
     for (;;) {
+        if (isAddressParitySwitchPending()) {
+            if (!waitForAddressParitySwitch(qt_subtract_from_timeout(msecs, stopWatch.elapsed())))
+                return false;
+            continue;
+        }
+
         bool readyToRead = false;
         bool readyToWrite = false;
         const bool checkRead = q_func()->isReadable();
-        if (!waitForReadOrWrite(&readyToRead, &readyToWrite, checkRead, !writeBuffer.isEmpty(),
+        const bool checkWrite = hasPendingWriteData() || writeSequenceStarted;
+        if (!waitForReadOrWrite(&readyToRead, &readyToWrite, checkRead, checkWrite,
                                 qt_subtract_from_timeout(msecs, stopWatch.elapsed()))) {
             return false;
         }
@@ -696,8 +875,12 @@ bool QSerialPortPrivate::setParity(QSerialPort::Parity parity)
         return false;
 
     qt_set_parity(&tio, parity);
+    qt_set_error_marking(&tio, receiveErrorMarking);
 
-    return setTermios(&tio);
+    if (!setTermios(&tio))
+        return false;
+    addressParityActive = false;
+    return true;
 }
 
 bool QSerialPortPrivate::setStopBits(QSerialPort::StopBits stopBits)
@@ -722,68 +905,226 @@ bool QSerialPortPrivate::setFlowControl(QSerialPort::FlowControl flowControl)
     return setTermios(&tio);
 }
 
+bool QSerialPortPrivate::setMinimumReadSize(int bytes)
+{
+    termios tio;
+    if (!getTermios(&tio))
+        return false;
+
+    qt_set_minimum_read_size(&tio, bytes);
+
+    return setTermios(&tio);
+}
+
+bool QSerialPortPrivate::setRs485(const QSerialPort::Rs485Settings &settings)
+{
+    // Nothing to restore if the mode was never enabled by us.
+    if (!settings.enabled && !restoredRs485Saved)
+        return true;
+
+#if defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID) && defined(TIOCSRS485) && defined(TIOCGRS485)
+    if (!restoredRs485Saved) {
+        if (::ioctl(descriptor, TIOCGRS485, &restoredRs485) == -1) {
+            setError(getSystemError());
+            return false;
+        }
+        restoredRs485Saved = true;
+    }
+
+    struct serial_rs485 rs485;
+    ::memset(&rs485, 0, sizeof(rs485));
+    if (settings.enabled) {
+        rs485.flags = SER_RS485_ENABLED;
+        if (settings.rtsOnSend)
+            rs485.flags |= SER_RS485_RTS_ON_SEND;
+        if (settings.rtsAfterSend)
+            rs485.flags |= SER_RS485_RTS_AFTER_SEND;
+#ifdef SER_RS485_RX_DURING_TX
+        if (settings.receiveDuringTransmit)
+            rs485.flags |= SER_RS485_RX_DURING_TX;
+#endif
+        rs485.delay_rts_before_send = quint32(settings.delayBeforeSend.count());
+        rs485.delay_rts_after_send = quint32(settings.delayAfterSend.count());
+    }
+
+    if (::ioctl(descriptor, TIOCSRS485, &rs485) == -1) {
+        setError(getSystemError());
+        return false;
+    }
+    return true;
+#else
+    setError(QSerialPortErrorInfo(QSerialPort::UnsupportedOperationError,
+                                  QSerialPort::tr("RS-485 mode is not supported on this platform")));
+    return false;
+#endif
+}
+
+bool QSerialPortPrivate::setReceiveErrorMarking(bool enable)
+{
+    termios tio;
+    if (!getTermios(&tio))
+        return false;
+
+    qt_set_parity(&tio, parity);
+    qt_set_error_marking(&tio, enable);
+
+    return setTermios(&tio);
+}
+
 bool QSerialPortPrivate::startAsyncRead()
 {
     setReadNotificationEnabled(true);
+    setReadPaused(false);
     return true;
 }
 
 bool QSerialPortPrivate::readNotification()
 {
-    Q_Q(QSerialPort);
+    // With hardware flow control, the driver throttles the peer
+    // once its queue fills up.
+    if (inputThrottled && flowControl == QSerialPort::HardwareControl) {
+        setReadNotificationEnabled(false);
+        setReadPaused(true);
+        return false;
+    }
+
+    // The notification may only be about written data.
+    if (ioThread && !ioThread->hasReadData())
+        return false;
 
     // Always buffered, read data from the port into the read buffer
     qint64 newBytes = buffer.size();
-    qint64 bytesToRead = QSERIALPORT_BUFFERSIZE;
-
-    if (readBufferMaxSize && bytesToRead > (readBufferMaxSize - buffer.size())) {
-        bytesToRead = readBufferMaxSize - buffer.size();
-        if (bytesToRead <= 0) {
-            // Buffer is full. User must read data from the buffer
-            // before we can read more from the port.
-            setReadNotificationEnabled(false);
-            return false;
+    qint64 remainingBudget = readDrainBudget;
+    bool result = true;
+
+    do {
+        qint64 bytesToRead = nextReadChunkSize();
+        if (remainingBudget > 0)
+            bytesToRead = qMin(bytesToRead, remainingBudget);
+
+        if (isDiscardingOldestData() && bytesToRead > (readBufferMaxSize - buffer.size())) {
+            // Overflow into the buffer for a single read, the oldest data
+            // is discarded once the new data has been processed.
+            bytesToRead = qMin(bytesToRead, readBufferMaxSize);
+            remainingBudget = 0;
+        } else if (readBufferMaxSize && bytesToRead > (readBufferMaxSize - buffer.size())) {
+            bytesToRead = readBufferMaxSize - buffer.size();
+            if (bytesToRead <= 0) {
+                // Buffer is full. User must read data from the buffer
+                // before we can read more from the port.
+                setReadNotificationEnabled(false);
+                setReadPaused(true);
+                break;
+            }
         }
-    }
 
-    char *ptr = buffer.reserve(bytesToRead);
-    const qint64 readBytes = readFromPort(ptr, bytesToRead);
+        // Reading into the ring buffer directly may allocate a whole new
+        // chunk for just a few bytes, which are then chopped off again.
+        // The scratch buffer is allocated once, and only the bytes actually
+        // read are appended to the ring buffer.
+        const bool useScratchBuffer = preallocatedReadBuffer;
+        if (useScratchBuffer && readScratchBuffer.size() != readBufferChunkSize)
+            readScratchBuffer = QByteArray(readBufferChunkSize, Qt::Uninitialized);
+
+        // Otherwise, only reserve what is actually queued in the driver.
+        // If nothing is reported, read anyway to pick up errors.
+        const qint64 chunkSize = bytesToRead;
+        qint64 queuedBytes = 0;
+        if (!useScratchBuffer) {
+            queuedBytes = ioThread ? ioThread->bytesAvailable()
+                                   : queuedBytesCount(QSerialPort::Input);
+            if (queuedBytes > 0)
+                bytesToRead = qMin(bytesToRead, queuedBytes);
+        }
 
-    buffer.chop(bytesToRead - qMax(readBytes, qint64(0)));
+        // An escape at the end of the previous chunk is put back in front
+        // of this one, as it has to be kept if it turns out not to be a mark.
+        const qint64 pendingEscape = receiveErrorMarking
+                && errorMarkState == ErrorMarkEscape ? 1 : 0;
+        if (useScratchBuffer)
+            bytesToRead = qMin(bytesToRead, readScratchBuffer.size() - pendingEscape);
+
+        const qint64 chunkOffset = receivedBytesTotal + buffer.size() - newBytes;
+        char *ptr = useScratchBuffer ? readScratchBuffer.data()
+                                     : buffer.reserve(bytesToRead + pendingEscape);
+        const qint64 readBytes = readFromPort(ptr + pendingEscape, bytesToRead);
+        const int readErrno = errno;
+
+        qint64 decodedBytes = readBytes;
+        if (receiveErrorMarking && readBytes > 0) {
+            if (pendingEscape) {
+                ptr[0] = '\xFF';
+                errorMarkState = NoErrorMark;
+            }
+            decodedBytes = decodeErrorMarks(ptr, readBytes + pendingEscape, chunkOffset);
+        }
 
-    if (readBytes < 0) {
-        QSerialPortErrorInfo error = getSystemError();
-        if (error.errorCode != QSerialPort::ResourceError)
-            error.errorCode = QSerialPort::ReadError;
-        else
-            setReadNotificationEnabled(false);
-        setError(error);
-        return false;
-    } else if (readBytes == 0) {
-        return false;
-    }
+        if (!useScratchBuffer)
+            buffer.chop(bytesToRead + pendingEscape - qMax(decodedBytes, qint64(0)));
+        else if (decodedBytes > 0)
+            buffer.append(ptr, decodedBytes);
+
+        // The adaptive chunk size follows the backlog in the driver, and
+        // not the reads which have been trimmed to it.
+        updateReadChunkSize(chunkSize, qMax(queuedBytes, readBytes));
+
+        if (readBytes < 0) {
+            // The driver queue has been drained completely.
+            if (buffer.size() > newBytes && (readErrno == EAGAIN || readErrno == EWOULDBLOCK))
+                break;
+
+            QSerialPortErrorInfo error = getSystemError(readErrno);
+            if (error.errorCode != QSerialPort::ResourceError)
+                error.errorCode = QSerialPort::ReadError;
+            else
+                setReadNotificationEnabled(false);
+            setError(error);
+            result = false;
+            break;
+        } else if (readBytes == 0) {
+            break;
+        }
+
+        if (receiveTimestampsEnabled)
+            recordReceiveTimestamp(receivedBytesTotal + buffer.size() - newBytes);
+
+        // A short read means that there is nothing left in the driver
+        // queue, so save the syscall which would just fail with EAGAIN.
+        if (readBytes < bytesToRead || readBytes == queuedBytes)
+            break;
+
+        remainingBudget -= readBytes;
+    } while (remainingBudget > 0);
 
     newBytes = buffer.size() - newBytes;
 
-    // only emit readyRead() when not recursing, and only if there is data available
+    // only emit readyRead() if there is data available
     const bool hasData = newBytes > 0;
 
-    if (!emittedReadyRead && hasData) {
-        emittedReadyRead = true;
-        emit q->readyRead();
-        emittedReadyRead = false;
-    }
+    if (hasData)
+        processReceivedData(newBytes);
 
-    return true;
+    return result && hasData;
 }
 
 bool QSerialPortPrivate::startAsyncWrite()
 {
-    if (writeBuffer.isEmpty() || writeSequenceStarted)
+    if (ioThread && !writeSequenceStarted) {
+        if (!isDirectWriteRequired())
+            return startIoThreadWrite();
+
+        // Continued once the I/O thread has written everything before.
+        if (ioThread->bytesToWrite() > 0) {
+            setWriteNotificationEnabled(false);
+            return true;
+        }
+    }
+
+    if (!hasPendingWriteData() || writeSequenceStarted)
         return true;
 
-    // Attempt to write it all in one chunk.
-    qint64 written = writeToPort(writeBuffer.readPointer(), writeBuffer.nextDataBlockSize());
+    // Attempt to write it all with a single syscall.
+    qint64 written = writeBufferToPort();
     if (written < 0) {
         QSerialPortErrorInfo error = getSystemError();
         if (error.errorCode != QSerialPort::ResourceError)
@@ -792,10 +1133,18 @@ bool QSerialPortPrivate::startAsyncWrite()
         return false;
     }
 
-    writeBuffer.free(written);
+    consumeWriteLanes(written);
     pendingBytesWritten += written;
     writeSequenceStarted = true;
 
+    // Continued by the timer once the driver queue has drained.
+    if (isAddressParitySwitchPending()) {
+        setWriteNotificationEnabled(false);
+        return true;
+    }
+
+    recordWriteSubmission();
+
     if (!isWriteNotificationEnabled())
         setWriteNotificationEnabled(true);
     return true;
@@ -805,6 +1154,7 @@ bool QSerialPortPrivate::completeAsyncWrite()
 {
     Q_Q(QSerialPort);
 
+    const bool wrote = pendingBytesWritten > 0;
     if (pendingBytesWritten > 0) {
         if (!emittedBytesWritten) {
             emittedBytesWritten = true;
@@ -816,8 +1166,10 @@ bool QSerialPortPrivate::completeAsyncWrite()
 
     writeSequenceStarted = false;
 
-    if (writeBuffer.isEmpty()) {
+    if (!hasPendingWriteData()) {
         setWriteNotificationEnabled(false);
+        if (wrote)
+            scheduleTransmitCompleteCheck();
         return true;
     }
 
@@ -836,10 +1188,13 @@ inline bool QSerialPortPrivate::initialize(QIODevice::OpenMode mode)
         return false;
 
     restoredTermios = tio;
+    restoredRs485Saved = false;
 
     qt_set_common_props(&tio, mode);
+    qt_set_minimum_read_size(&tio, minimumReadSize);
     qt_set_databits(&tio, dataBits);
     qt_set_parity(&tio, parity);
+    qt_set_error_marking(&tio, receiveErrorMarking);
     qt_set_stopbits(&tio, stopBits);
     qt_set_flowcontrol(&tio, flowControl);
 
@@ -849,23 +1204,68 @@ inline bool QSerialPortPrivate::initialize(QIODevice::OpenMode mode)
     if (!setBaudRate())
         return false;
 
-    if (mode & QIODevice::ReadOnly)
-        setReadNotificationEnabled(true);
+    if (rs485Settings.enabled && !setRs485(rs485Settings))
+        return false;
 
     // flush IO buffers
     clear(QSerialPort::AllDirections);
 
+    if (ioThreadEnabled && !startIoThread(mode))
+        return false;
+
+    if (mode & QIODevice::ReadOnly)
+        setReadNotificationEnabled(true);
+
     return true;
 }
 
 qint64 QSerialPortPrivate::writeData(const char *data, qint64 maxSize)
 {
-    writeBuffer.append(data, maxSize);
-    if (!writeBuffer.isEmpty() && !isWriteNotificationEnabled())
-        setWriteNotificationEnabled(true);
+    qint64 written = 0;
+    if (immediateWrite && writeCoalescingDelay.count() <= 0 && !hasPendingWriteData()
+            && !addressParityActive && !ioThread) {
+        // Nothing is queued, so the data does not have to wait for the
+        // write notifier. On failure, including EAGAIN, everything is
+        // buffered and a real error is reported by startAsyncWrite().
+        written = qMax(writeToPort(data, maxSize), qint64(0));
+        advanceNormalWriteLane(written);
+        if (written > 0) {
+            // bytesWritten() is still emitted from the write notifier.
+            pendingBytesWritten += written;
+            writeSequenceStarted = true;
+            if (!isWriteNotificationEnabled())
+                setWriteNotificationEnabled(true);
+        }
+    }
+
+    if (written < maxSize) {
+        if (isWriteChunkCached(data, maxSize)) {
+            // Called from write(const QByteArray &), so keep a shallow copy
+            // of the payload and only skip the part written above.
+            writeBuffer.append(*currentWriteChunk);
+            writeBuffer.free(written);
+        } else {
+            writeBuffer.append(data + written, maxSize - written);
+        }
+    }
+    recordWriteUnit();
+    coalesceWrite();
     return maxSize;
 }
 
+void QSerialPortPrivate::scheduleAsyncWrite()
+{
+    // The I/O thread writes in the background anyway, so there is no
+    // need to wait for the event loop.
+    if (ioThread && !writeSequenceStarted && !isDirectWriteRequired()) {
+        startIoThreadWrite();
+        return;
+    }
+
+    if (hasPendingWriteData() && !isWriteNotificationEnabled())
+        setWriteNotificationEnabled(true);
+}
+
 bool QSerialPortPrivate::setTermios(const termios *tio)
 {
     if (::tcsetattr(descriptor, TCSANOW, tio) == -1) {
@@ -951,6 +1351,8 @@ QSerialPortErrorInfo QSerialPortPrivate::getSystemError(int systemErrorCode) con
 
 bool QSerialPortPrivate::isReadNotificationEnabled() const
 {
+    if (ioThread)
+        return ioThreadReadEnabled;
     return readNotifier && readNotifier->isEnabled();
 }
 
@@ -958,7 +1360,12 @@ void QSerialPortPrivate::setReadNotificationEnabled(bool enable)
 {
     Q_Q(QSerialPort);
 
-    if (readNotifier) {
+    if (ioThread) {
+        // Picks up the data the I/O thread has received in the meantime.
+        if (enable && !ioThreadReadEnabled)
+            ioThread->postNotification();
+        ioThreadReadEnabled = enable;
+    } else if (readNotifier) {
         readNotifier->setEnabled(enable);
     } else if (enable) {
         readNotifier = new ReadNotifier(this, q);
@@ -998,7 +1405,32 @@ bool QSerialPortPrivate::waitForReadOrWrite(bool *selectForRead, bool *selectFor
     if (checkWrite)
         pfd.events |= POLLOUT;
 
-    const int ret = qt_safe_poll(&pfd, 1, QDeadlineTimer(msecs));
+    // With a minimum read size, poll() does not report partial batches,
+    // so wake up after each inter-byte timeout and check whether the
+    // number of bytes queued in the driver has stopped growing.
+    const bool checkPartialBatch = checkRead && minimumReadSize > 1
+            && interByteTimeout.count() > 0;
+    const QDeadlineTimer deadline(msecs);
+    qint64 queuedBytes = 0;
+
+    int ret = 0;
+    for (;;) {
+        const QDeadlineTimer pollDeadline = checkPartialBatch
+                ? qMin(deadline, QDeadlineTimer(interByteTimeout))
+                : deadline;
+        ret = qt_safe_poll(&pfd, 1, pollDeadline);
+        if (ret != 0 || !checkPartialBatch || deadline.hasExpired())
+            break;
+
+        const qint64 currentQueuedBytes = queuedBytesCount(QSerialPort::Input);
+        if (currentQueuedBytes > 0 && currentQueuedBytes == queuedBytes) {
+            *selectForWrite = false;
+            *selectForRead = true;
+            return true;
+        }
+        queuedBytes = currentQueuedBytes;
+    }
+
     if (ret < 0) {
         setError(getSystemError());
         return false;
@@ -1017,11 +1449,332 @@ bool QSerialPortPrivate::waitForReadOrWrite(bool *selectForRead, bool *selectFor
     return true;
 }
 
+qint64 QSerialPortPrivate::queuedBytesCount(QSerialPort::Direction direction) const
+{
+    int bytes = 0;
+    if (direction == QSerialPort::Input) {
+        if (::ioctl(descriptor, FIONREAD, &bytes) == -1)
+            return -1;
+    } else if (direction == QSerialPort::Output) {
+#ifdef TIOCOUTQ
+        if (::ioctl(descriptor, TIOCOUTQ, &bytes) == -1)
+            return -1;
+#else
+        return -1;
+#endif
+    } else {
+        return -1;
+    }
+    return bytes;
+}
+
+qint64 QSerialPortPrivate::transmitterQueueSize() const
+{
+    const qint64 queuedBytes = queuedBytesCount(QSerialPort::Output);
+    if (queuedBytes != 0)
+        return queuedBytes;
+
+#if defined(TIOCSERGETLSR) && defined(TIOCSER_TEMT)
+    // The last character may still be in the shift register.
+    unsigned int lineStatus = 0;
+    if (::ioctl(descriptor, TIOCSERGETLSR, &lineStatus) != -1 && !(lineStatus & TIOCSER_TEMT))
+        return 1;
+#endif
+    return 0;
+}
+
 qint64 QSerialPortPrivate::readFromPort(char *data, qint64 maxSize)
 {
+    if (ioThread)
+        return ioThread->read(data, maxSize);
     return qt_safe_read(descriptor, data, maxSize);
 }
 
+template <typename Buffer>
+static void qt_gather_write_blocks(QVarLengthArray<iovec, 32> *blocks, const Buffer &buffer,
+                                   qint64 maxSize, int maxBlocks)
+{
+    qint64 position = 0;
+    while (position < maxSize && blocks->size() < maxBlocks) {
+        qint64 blockSize = 0;
+        const char *block = buffer.readPointerAtPosition(position, blockSize);
+        blockSize = qMin(blockSize, maxSize - position);
+        blocks->append({ const_cast<char *>(block), size_t(blockSize) });
+        position += blockSize;
+    }
+}
+
+qint64 QSerialPortPrivate::writeBufferToPort()
+{
+#if defined(IOV_MAX)
+    static constexpr int MaxWriteBlocks = IOV_MAX;
+#else
+    static constexpr int MaxWriteBlocks = 16;
+#endif
+
+#if defined(CMSPAR)
+    const bool parityEmulated = false;
+#else
+    const bool parityEmulated = parity == QSerialPort::MarkParity
+            || parity == QSerialPort::SpaceParity;
+#endif
+
+    if (!addressOffsets.isEmpty() || addressParityActive)
+        return writeAddressedToPort();
+
+    QVarLengthArray<iovec, 32> blocks;
+    if (urgentWriteBuffer.isEmpty()) {
+        const qint64 firstBlockSize = writeBuffer.nextDataBlockSize();
+        if (firstBlockSize == writeBuffer.size() || parityEmulated)
+            return writeToPort(writeBuffer.readPointer(), firstBlockSize);
+
+        // The write buffer consists of several blocks, gather all of them
+        // instead of paying for a syscall and a notification per block.
+        qt_gather_write_blocks(&blocks, writeBuffer, writeBuffer.size(), MaxWriteBlocks);
+    } else if (isUrgentWriteDue()) {
+        qt_gather_write_blocks(&blocks, urgentWriteBuffer, urgentWriteBuffer.size(),
+                               MaxWriteBlocks);
+        qt_gather_write_blocks(&blocks, writeBuffer, writeBuffer.size(), MaxWriteBlocks);
+    } else {
+        // Finish the normal priority write in progress first.
+        qt_gather_write_blocks(&blocks, writeBuffer, pendingWriteUnitSize(), MaxWriteBlocks);
+    }
+
+    if (blocks.size() == 1 || parityEmulated)
+        return writeToPort(static_cast<const char *>(blocks[0].iov_base), qint64(blocks[0].iov_len));
+
+    qint64 bytesWritten = 0;
+    EINTR_LOOP(bytesWritten, ::writev(descriptor, blocks.constData(), int(blocks.size())));
+    return bytesWritten;
+}
+
+bool QSerialPortPrivate::startIoThread(QIODevice::OpenMode mode)
+{
+    Q_Q(QSerialPort);
+
+    auto thread = std::make_unique<QSerialPortIoThread>(
+                descriptor, mode.testFlag(QIODevice::ReadOnly),
+                qMax(qint64(QSERIALPORT_BUFFERSIZE), qint64(readBufferChunkSize)));
+    if (!thread->initialize()) {
+        setError(getSystemError());
+        return false;
+    }
+
+    ioThread = std::move(thread);
+    ioThreadNotifier = new IoThreadNotifier(this, q);
+    ioThread->start(QThread::HighestPriority);
+    return true;
+}
+
+void QSerialPortPrivate::ioThreadNotification()
+{
+    ioThread->clearNotification();
+
+    if (isReadNotificationEnabled())
+        readNotification();
+
+    if (takeIoThreadWrites() > 0)
+        completeAsyncWrite();
+}
+
+// Waits for a notification of the I/O thread, or for the port to be ready
+// for a write which is left to this thread.
+bool QSerialPortPrivate::waitForIoThread(bool *notified, bool *selectForWrite, int msecs)
+{
+    Q_ASSERT(notified);
+    Q_ASSERT(selectForWrite);
+
+    pollfd pfds[2] = {
+        qt_make_pollfd(ioThread->notificationDescriptor(), POLLIN),
+        qt_make_pollfd(isWriteNotificationEnabled() ? descriptor : -1, POLLOUT)
+    };
+
+    const int ret = qt_safe_poll(pfds, 2, QDeadlineTimer(msecs));
+    if (ret < 0) {
+        setError(getSystemError());
+        return false;
+    }
+    if (ret == 0) {
+        setError(QSerialPortErrorInfo(QSerialPort::TimeoutError));
+        return false;
+    }
+
+    *notified = ((pfds[0].revents & POLLIN) != 0);
+    if (*notified)
+        ioThread->clearNotification();
+    *selectForWrite = ((pfds[1].revents & POLLOUT) != 0);
+    return true;
+}
+
+// The parity has to be switched in step with the data, which is only
+// possible when writing from this thread.
+bool QSerialPortPrivate::isDirectWriteRequired() const
+{
+#if defined(CMSPAR)
+    const bool parityEmulated = false;
+#else
+    const bool parityEmulated = parity == QSerialPort::MarkParity
+            || parity == QSerialPort::SpaceParity;
+#endif
+
+    return parityEmulated || !addressOffsets.isEmpty() || addressParityActive;
+}
+
+bool QSerialPortPrivate::startIoThreadWrite()
+{
+    if (!hasPendingWriteData())
+        return true;
+
+    const qint64 written = writeBufferToIoThread();
+    if (written > 0) {
+        consumeWriteLanes(written);
+        recordWriteSubmission();
+    }
+    return true;
+}
+
+// Hands the data over in the same order as writeBufferToPort(), up to
+// the space left in the ring buffer of the I/O thread.
+qint64 QSerialPortPrivate::writeBufferToIoThread()
+{
+    static constexpr int MaxWriteBlocks = 32;
+
+    QVarLengthArray<iovec, 32> blocks;
+    if (urgentWriteBuffer.isEmpty()) {
+        qt_gather_write_blocks(&blocks, writeBuffer, writeBuffer.size(), MaxWriteBlocks);
+    } else if (isUrgentWriteDue()) {
+        qt_gather_write_blocks(&blocks, urgentWriteBuffer, urgentWriteBuffer.size(),
+                               MaxWriteBlocks);
+        qt_gather_write_blocks(&blocks, writeBuffer, writeBuffer.size(), MaxWriteBlocks);
+    } else {
+        qt_gather_write_blocks(&blocks, writeBuffer, pendingWriteUnitSize(), MaxWriteBlocks);
+    }
+
+    qint64 written = 0;
+    for (const iovec &block : std::as_const(blocks)) {
+        const qint64 blockWritten = ioThread->write(static_cast<const char *>(block.iov_base),
+                                                    qint64(block.iov_len));
+        written += blockWritten;
+        if (blockWritten < qint64(block.iov_len))
+            break;
+    }
+    return written;
+}
+
+// Returns the number of bytes the I/O thread has written since the last
+// call, which are reported by the next bytesWritten() signal.
+qint64 QSerialPortPrivate::takeIoThreadWrites()
+{
+    if (const int writeError = ioThread->takeWriteError()) {
+        QSerialPortErrorInfo error = getSystemError(writeError);
+        if (error.errorCode != QSerialPort::ResourceError)
+            error.errorCode = QSerialPort::WriteError;
+        setError(error);
+        return -1;
+    }
+
+    const qint64 written = ioThread->takeWrittenBytes();
+    pendingBytesWritten += written;
+    return written;
+}
+
+// Writes up to the next change between the address and the data bytes
+// of multidrop frames, switching the parity before if needed.
+qint64 QSerialPortPrivate::writeAddressedToPort()
+{
+    const bool urgent = isUrgentWriteDue();
+    const bool address = !urgent && !addressOffsets.isEmpty()
+            && addressOffsets.constFirst() == submittedNormalBytes;
+    if (address != addressParityActive) {
+#if defined(CMSPAR)
+        // The characters already queued have to go out with the previous
+        // parity. Instead of blocking in tcsetattr(TCSADRAIN), nothing is
+        // written until the driver reports its queue as empty.
+        const qint64 queuedBytes = transmitterQueueSize();
+        if (queuedBytes > 0) {
+            scheduleAddressParitySwitch(queuedBytes);
+            return 0;
+        }
+        const bool drain = queuedBytes < 0;
+#else
+        const bool drain = false;
+#endif
+        if (!setAddressParity(address, drain))
+            return -1;
+    }
+
+    if (urgent)
+        return writeToPort(urgentWriteBuffer.readPointer(), urgentWriteBuffer.nextDataBlockSize());
+
+    qint64 size = address ? 1 : writeBuffer.nextDataBlockSize();
+    if (!address && !addressOffsets.isEmpty())
+        size = qMin(size, addressOffsets.constFirst() - submittedNormalBytes);
+    return writeToPort(writeBuffer.readPointer(), size);
+}
+
+void QSerialPortPrivate::scheduleAddressParitySwitch(qint64 queuedBytes)
+{
+    Q_Q(QSerialPort);
+
+    if (!addressParityTimer) {
+        addressParityTimer = new QChronoTimer(q);
+        addressParityTimer->setSingleShot(true);
+        addressParityTimer->setTimerType(Qt::PreciseTimer);
+        QObjectPrivate::connect(addressParityTimer, &QChronoTimer::timeout,
+                                this, &QSerialPortPrivate::completeAsyncWrite);
+    }
+    // Check again when the queued data should have left the wire.
+    addressParityTimer->setInterval(transmitTime(queuedBytes));
+    addressParityTimer->start();
+}
+
+bool QSerialPortPrivate::isAddressParitySwitchPending() const
+{
+    return addressParityTimer && addressParityTimer->isActive();
+}
+
+// Used by the blocking functions, which cannot rely on the event loop
+// for the timer.
+bool QSerialPortPrivate::waitForAddressParitySwitch(int msecs)
+{
+    const QDeadlineTimer deadline(msecs);
+    const std::chrono::nanoseconds due = addressParityTimer->remainingTime();
+    if (deadline.remainingTimeAsDuration() < due) {
+        QThread::sleep(deadline.remainingTimeAsDuration());
+        setError(QSerialPortErrorInfo(QSerialPort::TimeoutError));
+        return false;
+    }
+
+    QThread::sleep(due);
+    addressParityTimer->stop();
+    return completeAsyncWrite();
+}
+
+bool QSerialPortPrivate::setAddressParity(bool enable, bool drain)
+{
+#if defined(CMSPAR)
+    termios tio;
+    if (!getTermios(&tio))
+        return false;
+
+    if (enable)
+        tio.c_cflag |= PARODD;
+    else
+        tio.c_cflag &= ~PARODD;
+
+    // Only drains if the size of the driver queue is unknown.
+    if (::tcsetattr(descriptor, drain ? TCSADRAIN : TCSANOW, &tio) == -1) {
+        setError(getSystemError());
+        return false;
+    }
+#else
+    Q_UNUSED(drain);
+#endif
+    // Without CMSPAR, writePerChar() emulates the mark parity.
+    addressParityActive = enable;
+    return true;
+}
+
 qint64 QSerialPortPrivate::writeToPort(const char *data, qint64 maxSize)
 {
     qint64 bytesWritten = 0;
@@ -1057,27 +1810,36 @@ qint64 QSerialPortPrivate::writePerChar(const char *data, qint64 maxSize)
 
     qint64 ret = 0;
     quint8 const charMask = (0xFF >> (8 - dataBits));
+    const bool markParity = parity == QSerialPort::MarkParity || addressParityActive;
 
-    while (ret < maxSize) {
+    // False if need EVEN, true if need ODD.
+    const auto needsOddParity = [charMask, markParity](char c) {
+        return evenParity(c & charMask) ^ markParity;
+    };
 
-        bool par = evenParity(*data & charMask);
-        // False if need EVEN, true if need ODD.
-        par ^= parity == QSerialPort::MarkParity;
-        if (par ^ (tio.c_cflag & PARODD)) { // Need switch parity mode?
+    while (ret < maxSize) {
+        // Write all the following characters which need the same
+        // parity mode at once.
+        const bool oddParity = needsOddParity(data[ret]);
+        qint64 groupSize = 1;
+        while (ret + groupSize < maxSize && needsOddParity(data[ret + groupSize]) == oddParity)
+            ++groupSize;
+
+        if (oddParity != bool(tio.c_cflag & PARODD)) { // Need switch parity mode?
             tio.c_cflag ^= PARODD;
-            flush(); //force sending already buffered data, because setTermios(&tio); cleares buffers
-            //todo: add receiving buffered data!!!
-            if (!setTermios(&tio))
-                break;
+            // Let the characters already queued go out with the previous
+            // parity, without discarding any received data.
+            // The caller reports the error from errno, as for the write.
+            if (::tcsetattr(descriptor, TCSADRAIN, &tio) == -1)
+                return ret > 0 ? ret : -1;
         }
 
-        int r = qt_safe_write(descriptor, data, 1);
-        if (r < 0)
-            return -1;
-        if (r > 0) {
-            data += r;
-            ret += r;
-        }
+        const qint64 written = qt_safe_write(descriptor, data + ret, groupSize);
+        if (written < 0)
+            return ret > 0 ? ret : -1;
+        ret += written;
+        if (written < groupSize)
+            break;
     }
     return ret;
 }
@@ -164,6 +164,9 @@ bool QSerialPortPrivate::open(QIODevice::OpenMode mode)
 
 void QSerialPortPrivate::close()
 {
+    // Otherwise the peer may be left waiting for XON, or for RTS.
+    setInputThrottled(false);
+
     ::CancelIo(handle);
 
     delete notifier;
@@ -252,6 +255,20 @@ bool QSerialPortPrivate::setRequestToSend(bool set)
     return setDcb(&dcb);
 }
 
+bool QSerialPortPrivate::setInputFlowStopped(bool stopped)
+{
+    DCB dcb;
+    if (!getDcb(&dcb))
+        return false;
+
+    if (!::TransmitCommChar(handle, stopped ? dcb.XoffChar : dcb.XonChar)) {
+        setError(getSystemError());
+        return false;
+    }
+
+    return true;
+}
+
 bool QSerialPortPrivate::flush()
 {
     return _q_startAsyncWrite();
@@ -318,7 +335,7 @@ bool QSerialPortPrivate::waitForReadyRead(int msecs)
 
         if (overlapped == &readCompletionOverlapped) {
             const qint64 readBytesForOneReadOperation = qint64(buffer.size()) - currentReadBufferSize;
-            if (readBytesForOneReadOperation == QSERIALPORT_BUFFERSIZE) {
+            if (readBytesForOneReadOperation == completedReadSize) {
                 currentReadBufferSize = buffer.size();
             } else if (readBytesForOneReadOperation == 0) {
                 if (initialReadBufferSize != currentReadBufferSize)
@@ -335,7 +352,7 @@ bool QSerialPortPrivate::waitForReadyRead(int msecs)
 
 bool QSerialPortPrivate::waitForBytesWritten(int msecs)
 {
-    if (writeBuffer.isEmpty() && writeChunkBuffer.isEmpty())
+    if (!hasPendingWriteData() && writeChunkBuffer.isEmpty())
         return false;
 
     if (!writeStarted && !_q_startAsyncWrite())
@@ -420,6 +437,36 @@ bool QSerialPortPrivate::setFlowControl(QSerialPort::FlowControl flowControl)
     return setDcb(&dcb);
 }
 
+bool QSerialPortPrivate::setMinimumReadSize(int bytes)
+{
+    if (bytes == 0)
+        return true;
+
+    setError(QSerialPortErrorInfo(QSerialPort::UnsupportedOperationError,
+                                  QSerialPort::tr("Minimum read size is unsupported")));
+    return false;
+}
+
+bool QSerialPortPrivate::setReceiveErrorMarking(bool enable)
+{
+    if (!enable)
+        return true;
+
+    setError(QSerialPortErrorInfo(QSerialPort::UnsupportedOperationError,
+                                  QSerialPort::tr("Receive error marking is unsupported")));
+    return false;
+}
+
+bool QSerialPortPrivate::setRs485(const QSerialPort::Rs485Settings &settings)
+{
+    if (!settings.enabled)
+        return true;
+
+    setError(QSerialPortErrorInfo(QSerialPort::UnsupportedOperationError,
+                                  QSerialPort::tr("RS-485 mode is unsupported")));
+    return false;
+}
+
 bool QSerialPortPrivate::completeAsyncCommunication(qint64 bytesTransferred)
 {
     communicationStarted = false;
@@ -436,13 +483,19 @@ bool QSerialPortPrivate::completeAsyncRead(qint64 bytesTransferred)
         readStarted = false;
         return false;
     }
-    if (bytesTransferred > 0)
+    if (bytesTransferred > 0) {
         buffer.append(readChunkBuffer.constData(), bytesTransferred);
+        if (receiveTimestampsEnabled)
+            recordReceiveTimestamp(receivedBytesTotal + bytesTransferred);
+    }
 
     readStarted = false;
+    // The next read may request a different size.
+    completedReadSize = requestedReadSize;
+    updateReadChunkSize(requestedReadSize, bytesTransferred);
 
     bool result = true;
-    if (bytesTransferred == QSERIALPORT_BUFFERSIZE
+    if (bytesTransferred == requestedReadSize
             || queuedBytesCount(QSerialPort::Input) > 0) {
         result = startAsyncRead();
     } else {
@@ -450,7 +503,7 @@ bool QSerialPortPrivate::completeAsyncRead(qint64 bytesTransferred)
     }
 
     if (bytesTransferred > 0)
-        emitReadyRead();
+        processReceivedData(bytesTransferred);
 
     return result;
 }
@@ -469,6 +522,8 @@ bool QSerialPortPrivate::completeAsyncWrite(qint64 bytesTransferred)
         writeChunkBuffer.clear();
         emit q->bytesWritten(bytesTransferred);
         writeStarted = false;
+        if (!hasPendingWriteData())
+            scheduleTransmitCompleteCheck();
     }
 
     return _q_startAsyncWrite();
@@ -498,19 +553,37 @@ bool QSerialPortPrivate::startAsyncRead()
     if (readStarted)
         return true;
 
-    qint64 bytesToRead = QSERIALPORT_BUFFERSIZE;
+    // With hardware flow control, the driver throttles the peer
+    // once its queue fills up.
+    if (inputThrottled && flowControl == QSerialPort::HardwareControl) {
+        setReadPaused(true);
+        return true;
+    }
+
+    qint64 bytesToRead = nextReadChunkSize();
 
-    if (readBufferMaxSize && bytesToRead > (readBufferMaxSize - buffer.size())) {
+    if (isDiscardingOldestData()) {
+        // The oldest data is discarded once the new data has been processed.
+        bytesToRead = qMin(bytesToRead, readBufferMaxSize);
+    } else if (readBufferMaxSize && bytesToRead > (readBufferMaxSize - buffer.size())) {
         bytesToRead = readBufferMaxSize - buffer.size();
         if (bytesToRead <= 0) {
             // Buffer is full. User must read data from the buffer
             // before we can read more from the port.
+            setReadPaused(true);
             return false;
         }
     }
 
+    // No read is pending here, so the chunk buffer can be safely reallocated
+    // if the chunk size was changed.
+    if (readChunkBuffer.size() != readBufferChunkSize)
+        readChunkBuffer = QByteArray(readBufferChunkSize, 0);
+
     Q_ASSERT(int(bytesToRead) <= readChunkBuffer.size());
 
+    setReadPaused(false);
+    requestedReadSize = bytesToRead;
     ::ZeroMemory(&readCompletionOverlapped, sizeof(readCompletionOverlapped));
     if (::ReadFile(handle, readChunkBuffer.data(), bytesToRead, nullptr, &readCompletionOverlapped)) {
         readStarted = true;
@@ -539,10 +612,23 @@ bool QSerialPortPrivate::_q_startAsyncWrite()
         return false;
     }
 
-    if (writeBuffer.isEmpty() || writeStarted)
+    if (!hasPendingWriteData() || writeStarted)
         return true;
 
-    writeChunkBuffer = writeBuffer.read();
+    const qint64 unitSize = pendingWriteUnitSize();
+    if (isUrgentWriteDue()) {
+        writeChunkBuffer = urgentWriteBuffer.read();
+        submittedUrgentBytes += writeChunkBuffer.size();
+    } else {
+        // Stop at the end of the current write if urgent data is waiting.
+        if (!urgentWriteBuffer.isEmpty() && unitSize < writeBuffer.nextDataBlockSize()) {
+            writeChunkBuffer = QByteArray(writeBuffer.readPointer(), unitSize);
+            writeBuffer.free(unitSize);
+        } else {
+            writeChunkBuffer = writeBuffer.read();
+        }
+        advanceNormalWriteLane(writeChunkBuffer.size());
+    }
     ::ZeroMemory(&writeCompletionOverlapped, sizeof(writeCompletionOverlapped));
     if (!::WriteFile(handle, writeChunkBuffer.constData(),
                      writeChunkBuffer.size(), nullptr, &writeCompletionOverlapped)) {
@@ -557,6 +643,7 @@ bool QSerialPortPrivate::_q_startAsyncWrite()
     }
 
     writeStarted = true;
+    recordWriteSubmission();
     return true;
 }
 
@@ -578,20 +665,28 @@ void QSerialPortPrivate::_q_notified(DWORD numberOfBytes, DWORD errorCode, OVERL
         Q_ASSERT(!"Unknown OVERLAPPED activated");
 }
 
-void QSerialPortPrivate::emitReadyRead()
+qint64 QSerialPortPrivate::writeData(const char *data, qint64 maxSize)
 {
-    Q_Q(QSerialPort);
-
-    emit q->readyRead();
+    // Called from write(const QByteArray &), so keep a shallow copy
+    // of the payload, which is then written by WriteFile() as is.
+    if (isWriteChunkCached(data, maxSize))
+        writeBuffer.append(*currentWriteChunk);
+    else
+        writeBuffer.append(data, maxSize);
+    recordWriteUnit();
+    coalesceWrite();
+    return maxSize;
 }
 
-qint64 QSerialPortPrivate::writeData(const char *data, qint64 maxSize)
+void QSerialPortPrivate::scheduleAsyncWrite()
 {
     Q_Q(QSerialPort);
 
-    writeBuffer.append(data, maxSize);
-
-    if (!writeBuffer.isEmpty() && !writeStarted) {
+    if (hasPendingWriteData() && !writeStarted) {
+        if (immediateWrite) {
+            _q_startAsyncWrite();
+            return;
+        }
         if (!startAsyncWriteTimer) {
             startAsyncWriteTimer = new QTimer(q);
             QObjectPrivate::connect(startAsyncWriteTimer, &QTimer::timeout, this, &QSerialPortPrivate::_q_startAsyncWrite);
@@ -600,7 +695,6 @@ qint64 QSerialPortPrivate::writeData(const char *data, qint64 maxSize)
         if (!startAsyncWriteTimer->isActive())
             startAsyncWriteTimer->start();
     }
-    return maxSize;
 }
 
 OVERLAPPED *QSerialPortPrivate::waitForNotified(QDeadlineTimer deadline)
@@ -623,6 +717,11 @@ qint64 QSerialPortPrivate::queuedBytesCount(QSerialPort::Direction direction) co
             : ((direction == QSerialPort::Output) ? comstat.cbOutQue : -1);
 }
 
+qint64 QSerialPortPrivate::transmitterQueueSize() const
+{
+    return queuedBytesCount(QSerialPort::Output);
+}
+
 inline bool QSerialPortPrivate::initialize(QIODevice::OpenMode mode)
 {
     Q_Q(QSerialPort);
@@ -643,6 +742,12 @@ inline bool QSerialPortPrivate::initialize(QIODevice::OpenMode mode)
     if (!setDcb(&dcb))
         return false;
 
+    if (rs485Settings.enabled && !setRs485(rs485Settings))
+        return false;
+
+    if (receiveErrorMarking && !setReceiveErrorMarking(true))
+        return false;
+
     if (!::GetCommTimeouts(handle, &restoredCommTimeouts)) {
         setError(getSystemError());
         return false;
@@ -0,0 +1,360 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qserialportframing_p.h"
+
+#include <QtCore/qalgorithms.h>
+#include <QtCore/private/qsimd_p.h>
+
+#include <cstring>
+#include <utility>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+// RFC 1055
+constexpr char SlipEnd = char(0xC0);
+constexpr char SlipEscape = char(0xDB);
+constexpr char SlipEscapedEnd = char(0xDC);
+constexpr char SlipEscapedEscape = char(0xDD);
+
+// RFC 1662
+constexpr char HdlcFlag = char(0x7E);
+constexpr char HdlcEscape = char(0x7D);
+constexpr char HdlcEscapeMask = char(0x20);
+}
+
+static inline void qt_append_decoded_frame(QList<QSerialPortFrame> *frames,
+                                           QByteArray &payload, qint64 end)
+{
+    QSerialPortFrame frame;
+    frame.end = end;
+    frame.payload = std::exchange(payload, QByteArray());
+    frame.decoded = true;
+    frames->append(std::move(frame));
+}
+
+// Returns the first occurrence of either a or b in [ptr, end), or end.
+static const char *qt_find_either(const char *ptr, const char *end, char a, char b)
+{
+#if defined(__SSE2__)
+    const __m128i aMask = _mm_set1_epi8(a);
+    const __m128i bMask = _mm_set1_epi8(b);
+    for (; end - ptr >= 16; ptr += 16) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ptr));
+        const __m128i matches = _mm_or_si128(_mm_cmpeq_epi8(data, aMask),
+                                             _mm_cmpeq_epi8(data, bMask));
+        if (const uint mask = uint(_mm_movemask_epi8(matches)))
+            return ptr + qCountTrailingZeroBits(mask);
+    }
+#endif
+    for (; ptr < end; ++ptr) {
+        if (*ptr == a || *ptr == b)
+            return ptr;
+    }
+    return end;
+}
+
+QSerialPortFrameDecoder::~QSerialPortFrameDecoder() = default;
+
+std::unique_ptr<QSerialPortFrameDecoder>
+QSerialPortFrameDecoder::create(QSerialPort::FramingProtocol protocol, int lengthPrefixSize)
+{
+    switch (protocol) {
+    case QSerialPort::SlipFraming:
+        return std::make_unique<QSerialPortSlipDecoder>();
+    case QSerialPort::CobsFraming:
+        return std::make_unique<QSerialPortCobsDecoder>();
+    case QSerialPort::HdlcFraming:
+        return std::make_unique<QSerialPortHdlcDecoder>();
+    case QSerialPort::LengthPrefixFraming:
+        return std::make_unique<QSerialPortLengthPrefixDecoder>(lengthPrefixSize);
+    case QSerialPort::NoFraming:
+        break;
+    }
+    return nullptr;
+}
+
+void QSerialPortByteStuffingDecoder::decode(const char *data, qint64 size, qint64 offset,
+                                            QList<QSerialPortFrame> *frames)
+{
+    const char *ptr = data;
+    const char *end = data + size;
+
+    while (ptr < end) {
+        const char *flagPtr = static_cast<const char *>(memchr(ptr, flag, end - ptr));
+        const char *segmentEnd = flagPtr ? flagPtr : end;
+
+        // The escape may have been the last byte of the previous chunk.
+        if (escaped && ptr < segmentEnd) {
+            frame.append(unescaped(*ptr++));
+            escaped = false;
+        }
+        appendEscaped(ptr, segmentEnd - ptr);
+
+        if (!flagPtr)
+            break;
+        ptr = flagPtr + 1;
+
+        // Empty frames only separate the real ones, and an escape right
+        // before the flag aborts the frame.
+        if (escaped || frame.isEmpty())
+            reset();
+        else
+            qt_append_decoded_frame(frames, frame, offset + (ptr - data));
+    }
+}
+
+void QSerialPortByteStuffingDecoder::reset()
+{
+    frame.clear();
+    escaped = false;
+}
+
+void QSerialPortByteStuffingDecoder::appendEscaped(const char *data, qint64 size)
+{
+    const char *ptr = data;
+    const char *end = data + size;
+
+    while (ptr < end) {
+        const char *escapePtr = static_cast<const char *>(memchr(ptr, escape, end - ptr));
+        if (!escapePtr) {
+            frame.append(ptr, end - ptr);
+            return;
+        }
+        frame.append(ptr, escapePtr - ptr);
+        ptr = escapePtr + 1;
+        if (ptr == end) {
+            escaped = true;
+            return;
+        }
+        frame.append(unescaped(*ptr++));
+    }
+}
+
+QSerialPortSlipDecoder::QSerialPortSlipDecoder()
+    : QSerialPortByteStuffingDecoder(SlipEnd, SlipEscape)
+{
+}
+
+char QSerialPortSlipDecoder::unescaped(char c) const
+{
+    // Other escaped bytes are a protocol violation,
+    // RFC 1055 recommends to keep them as is.
+    if (c == SlipEscapedEnd)
+        return SlipEnd;
+    if (c == SlipEscapedEscape)
+        return SlipEscape;
+    return c;
+}
+
+QSerialPortHdlcDecoder::QSerialPortHdlcDecoder()
+    : QSerialPortByteStuffingDecoder(HdlcFlag, HdlcEscape)
+{
+}
+
+char QSerialPortHdlcDecoder::unescaped(char c) const
+{
+    return c ^ HdlcEscapeMask;
+}
+
+void QSerialPortCobsDecoder::decode(const char *data, qint64 size, qint64 offset,
+                                    QList<QSerialPortFrame> *frames)
+{
+    const char *ptr = data;
+    const char *end = data + size;
+
+    while (ptr < end) {
+        if (remainingBlockSize > 0) {
+            const qint64 blockSize = qMin(qint64(remainingBlockSize), qint64(end - ptr));
+            if (const void *zero = memchr(ptr, 0, blockSize)) {
+                // The frame ended in the middle of a block, drop it.
+                reset();
+                ptr = static_cast<const char *>(zero) + 1;
+                continue;
+            }
+            frame.append(ptr, blockSize);
+            ptr += blockSize;
+            remainingBlockSize -= int(blockSize);
+            continue;
+        }
+
+        const uchar code = uchar(*ptr++);
+        if (code == 0) {
+            // The zero implied by the last block is not part of the payload.
+            if (inFrame)
+                qt_append_decoded_frame(frames, frame, offset + (ptr - data));
+            reset();
+            continue;
+        }
+
+        if (zeroPending)
+            frame.append('\0');
+        remainingBlockSize = code - 1;
+        zeroPending = code != 0xFF;
+        inFrame = true;
+    }
+}
+
+void QSerialPortCobsDecoder::reset()
+{
+    frame.clear();
+    remainingBlockSize = 0;
+    zeroPending = false;
+    inFrame = false;
+}
+
+void QSerialPortLengthPrefixDecoder::decode(const char *data, qint64 size, qint64 offset,
+                                            QList<QSerialPortFrame> *frames)
+{
+    const char *ptr = data;
+    const char *end = data + size;
+
+    for (;;) {
+        while (prefixBytesRead < prefixSize) {
+            if (ptr == end)
+                return;
+            payloadSize = (payloadSize << 8) | uchar(*ptr++);
+            if (++prefixBytesRead == prefixSize)
+                payloadStart = offset + (ptr - data);
+        }
+
+        const qint64 received = offset + (ptr - data) - payloadStart;
+        const qint64 available = qMin(qint64(payloadSize) - received, qint64(end - ptr));
+        ptr += available;
+        if (received + available < qint64(payloadSize))
+            return;
+
+        QSerialPortFrame frame;
+        frame.payloadStart = payloadStart;
+        frame.payloadEnd = payloadStart + payloadSize;
+        frame.end = frame.payloadEnd;
+        frames->append(std::move(frame));
+        reset();
+    }
+}
+
+void QSerialPortLengthPrefixDecoder::reset()
+{
+    prefixBytesRead = 0;
+    payloadSize = 0;
+    payloadStart = 0;
+}
+
+QSerialPortFrameEncoder::~QSerialPortFrameEncoder() = default;
+
+std::unique_ptr<QSerialPortFrameEncoder>
+QSerialPortFrameEncoder::create(QSerialPort::FramingProtocol protocol, int lengthPrefixSize)
+{
+    switch (protocol) {
+    case QSerialPort::SlipFraming:
+        return std::make_unique<QSerialPortSlipEncoder>();
+    case QSerialPort::CobsFraming:
+        return std::make_unique<QSerialPortCobsEncoder>();
+    case QSerialPort::HdlcFraming:
+        return std::make_unique<QSerialPortHdlcEncoder>();
+    case QSerialPort::LengthPrefixFraming:
+        return std::make_unique<QSerialPortLengthPrefixEncoder>(lengthPrefixSize);
+    case QSerialPort::NoFraming:
+        break;
+    }
+    return nullptr;
+}
+
+qint64 QSerialPortByteStuffingEncoder::maximumEncodedSize(qint64 size) const
+{
+    // Every byte may have to be escaped, plus the leading and trailing flag.
+    return size * 2 + 2;
+}
+
+qint64 QSerialPortByteStuffingEncoder::encode(const char *payload, qint64 size, char *out) const
+{
+    const char *end = payload + size;
+    char *ptr = out;
+
+    // The leading flag terminates any noise received before the frame.
+    *ptr++ = flag;
+    while (payload < end) {
+        const char *special = qt_find_either(payload, end, flag, escape);
+        memcpy(ptr, payload, special - payload);
+        ptr += special - payload;
+        if (special == end)
+            break;
+        *ptr++ = escape;
+        *ptr++ = escaped(*special);
+        payload = special + 1;
+    }
+    *ptr++ = flag;
+
+    return ptr - out;
+}
+
+QSerialPortSlipEncoder::QSerialPortSlipEncoder()
+    : QSerialPortByteStuffingEncoder(SlipEnd, SlipEscape)
+{
+}
+
+char QSerialPortSlipEncoder::escaped(char c) const
+{
+    return c == SlipEnd ? SlipEscapedEnd : SlipEscapedEscape;
+}
+
+QSerialPortHdlcEncoder::QSerialPortHdlcEncoder()
+    : QSerialPortByteStuffingEncoder(HdlcFlag, HdlcEscape)
+{
+}
+
+char QSerialPortHdlcEncoder::escaped(char c) const
+{
+    return c ^ HdlcEscapeMask;
+}
+
+qint64 QSerialPortCobsEncoder::maximumEncodedSize(qint64 size) const
+{
+    // One code byte per started block of 254 bytes, plus the delimiter.
+    return size + size / 254 + 2;
+}
+
+qint64 QSerialPortCobsEncoder::encode(const char *payload, qint64 size, char *out) const
+{
+    const char *end = payload + size;
+    char *ptr = out;
+
+    for (;;) {
+        const qint64 maximumBlockSize = qMin(qint64(end - payload), qint64(254));
+        const char *zero = static_cast<const char *>(memchr(payload, 0, maximumBlockSize));
+        const qint64 blockSize = zero ? zero - payload : maximumBlockSize;
+
+        *ptr++ = char(blockSize + 1);
+        memcpy(ptr, payload, blockSize);
+        ptr += blockSize;
+        payload += blockSize;
+
+        if (zero)
+            ++payload;
+        else if (payload == end)
+            break;
+    }
+    *ptr++ = '\0';
+
+    return ptr - out;
+}
+
+qint64 QSerialPortLengthPrefixEncoder::maximumEncodedSize(qint64 size) const
+{
+    return size + prefixSize;
+}
+
+qint64 QSerialPortLengthPrefixEncoder::encode(const char *payload, qint64 size, char *out) const
+{
+    if (prefixSize < 8 && size >= (qint64(1) << (prefixSize * 8)))
+        return -1;
+
+    for (int i = prefixSize - 1; i >= 0; --i)
+        *out++ = char(size >> (i * 8));
+    memcpy(out, payload, size);
+
+    return size + prefixSize;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,218 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QSERIALPORTFRAMING_P_H
+#define QSERIALPORTFRAMING_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "qserialport.h"
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qlist.h>
+#include <QtCore/private/qglobal_p.h>
+
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+
+// A complete frame found in the stream of received bytes. All the offsets
+// count the bytes received since the port was opened, so they stay valid
+// while data is consumed from the read buffer.
+struct QSerialPortFrame
+{
+    // Location of the payload, if it can be read as is from the buffer.
+    qint64 payloadStart = 0;
+    qint64 payloadEnd = 0;
+    // Offset just past the last byte which belongs to the frame.
+    qint64 end = 0;
+    // The payload of frames which had to be decoded.
+    QByteArray payload;
+    bool decoded = false;
+};
+
+// Extension point for the framing protocols. A decoder is fed with every
+// chunk of data right after it has been read from the port, and appends
+// the frames it completes to the list. It has to keep the state of a
+// partially received frame itself, as the raw data is not guaranteed to
+// stay in the read buffer.
+class QSerialPortFrameDecoder
+{
+public:
+    virtual ~QSerialPortFrameDecoder();
+
+    virtual void decode(const char *data, qint64 size, qint64 offset,
+                        QList<QSerialPortFrame> *frames) = 0;
+    virtual void reset() = 0;
+
+    static std::unique_ptr<QSerialPortFrameDecoder> create(QSerialPort::FramingProtocol protocol,
+                                                           int lengthPrefixSize);
+};
+
+// Decoder for the protocols which terminate each frame with a flag byte,
+// and escape the occurrences of the flag in the payload (SLIP and HDLC).
+class QSerialPortByteStuffingDecoder : public QSerialPortFrameDecoder
+{
+public:
+    QSerialPortByteStuffingDecoder(char flag, char escape)
+        : flag(flag), escape(escape)
+    {
+    }
+
+    void decode(const char *data, qint64 size, qint64 offset,
+                QList<QSerialPortFrame> *frames) override;
+    void reset() override;
+
+protected:
+    virtual char unescaped(char c) const = 0;
+
+private:
+    void appendEscaped(const char *data, qint64 size);
+
+    QByteArray frame;
+    const char flag;
+    const char escape;
+    bool escaped = false;
+};
+
+class QSerialPortSlipDecoder final : public QSerialPortByteStuffingDecoder
+{
+public:
+    QSerialPortSlipDecoder();
+
+protected:
+    char unescaped(char c) const override;
+};
+
+class QSerialPortHdlcDecoder final : public QSerialPortByteStuffingDecoder
+{
+public:
+    QSerialPortHdlcDecoder();
+
+protected:
+    char unescaped(char c) const override;
+};
+
+class QSerialPortCobsDecoder final : public QSerialPortFrameDecoder
+{
+public:
+    void decode(const char *data, qint64 size, qint64 offset,
+                QList<QSerialPortFrame> *frames) override;
+    void reset() override;
+
+private:
+    QByteArray frame;
+    int remainingBlockSize = 0;
+    bool zeroPending = false;
+    bool inFrame = false;
+};
+
+// The payload follows a big-endian length, so it is left in the read
+// buffer and only its location is recorded.
+class QSerialPortLengthPrefixDecoder final : public QSerialPortFrameDecoder
+{
+public:
+    explicit QSerialPortLengthPrefixDecoder(int prefixSize)
+        : prefixSize(prefixSize)
+    {
+    }
+
+    void decode(const char *data, qint64 size, qint64 offset,
+                QList<QSerialPortFrame> *frames) override;
+    void reset() override;
+
+private:
+    const int prefixSize;
+    int prefixBytesRead = 0;
+    quint32 payloadSize = 0;
+    qint64 payloadStart = 0;
+};
+
+// Counterpart of QSerialPortFrameDecoder on the write path. The frame is
+// encoded straight into the space reserved in the write buffer, so the
+// encoder has to report an upper bound of the encoded size first.
+class QSerialPortFrameEncoder
+{
+public:
+    virtual ~QSerialPortFrameEncoder();
+
+    virtual qint64 maximumEncodedSize(qint64 size) const = 0;
+    // Returns the number of bytes written to out, or -1 if the payload
+    // cannot be encoded.
+    virtual qint64 encode(const char *payload, qint64 size, char *out) const = 0;
+
+    static std::unique_ptr<QSerialPortFrameEncoder> create(QSerialPort::FramingProtocol protocol,
+                                                           int lengthPrefixSize);
+};
+
+class QSerialPortByteStuffingEncoder : public QSerialPortFrameEncoder
+{
+public:
+    QSerialPortByteStuffingEncoder(char flag, char escape)
+        : flag(flag), escape(escape)
+    {
+    }
+
+    qint64 maximumEncodedSize(qint64 size) const override;
+    qint64 encode(const char *payload, qint64 size, char *out) const override;
+
+protected:
+    virtual char escaped(char c) const = 0;
+
+private:
+    const char flag;
+    const char escape;
+};
+
+class QSerialPortSlipEncoder final : public QSerialPortByteStuffingEncoder
+{
+public:
+    QSerialPortSlipEncoder();
+
+protected:
+    char escaped(char c) const override;
+};
+
+class QSerialPortHdlcEncoder final : public QSerialPortByteStuffingEncoder
+{
+public:
+    QSerialPortHdlcEncoder();
+
+protected:
+    char escaped(char c) const override;
+};
+
+class QSerialPortCobsEncoder final : public QSerialPortFrameEncoder
+{
+public:
+    qint64 maximumEncodedSize(qint64 size) const override;
+    qint64 encode(const char *payload, qint64 size, char *out) const override;
+};
+
+class QSerialPortLengthPrefixEncoder final : public QSerialPortFrameEncoder
+{
+public:
+    explicit QSerialPortLengthPrefixEncoder(int prefixSize)
+        : prefixSize(prefixSize)
+    {
+    }
+
+    qint64 maximumEncodedSize(qint64 size) const override;
+    qint64 encode(const char *payload, qint64 size, char *out) const override;
+
+private:
+    const int prefixSize;
+};
+
+QT_END_NAMESPACE
+
+#endif // QSERIALPORTFRAMING_P_H
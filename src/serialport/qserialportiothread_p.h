@@ -0,0 +1,125 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QSERIALPORTIOTHREAD_P_H
+#define QSERIALPORTIOTHREAD_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qthread.h>
+#include <QtCore/private/qglobal_p.h>
+
+#include <atomic>
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+
+// Lock-free ring buffer for exactly one producer thread and one consumer
+// thread. The positions only ever grow, and wrap around together with the
+// capacity, which is a power of two.
+class QSerialPortSpscBuffer
+{
+public:
+    explicit QSerialPortSpscBuffer(qint64 capacity);
+
+    qint64 capacity() const { return qint64(mask + 1); }
+    qint64 size() const
+    { return qint64(tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire)); }
+    bool isEmpty() const { return size() == 0; }
+    bool isFull() const { return size() == capacity(); }
+
+    // Producer side. Returns the contiguous free space at the tail, which
+    // is published to the consumer by commit().
+    char *writePointer(qint64 *maxSize) const;
+    void commit(qint64 bytes);
+    qint64 write(const char *data, qint64 maxSize);
+
+    // Consumer side. Returns the contiguous data at the head, which is
+    // handed back to the producer by free().
+    const char *readPointer(qint64 *maxSize) const;
+    void free(qint64 bytes);
+    qint64 read(char *data, qint64 maxSize);
+
+private:
+    std::unique_ptr<char[]> data;
+    const quintptr mask;
+    // Kept apart, so that the two threads do not keep stealing the cache
+    // line from each other.
+    alignas(64) std::atomic<quintptr> head{0};
+    alignas(64) std::atomic<quintptr> tail{0};
+};
+
+// Polls the descriptor of an open port on a dedicated thread. The received
+// data is read into one ring buffer, and the data in the other one is
+// written to the port. The owner thread is notified through a pipe, with a
+// single notification for everything which happened since the last one.
+class QSerialPortIoThread final : public QThread
+{
+public:
+    QSerialPortIoThread(int descriptor, bool readable, qint64 bufferSize);
+    ~QSerialPortIoThread() override;
+
+    bool initialize();
+    void stop();
+
+    int notificationDescriptor() const { return notificationPipe[0]; }
+    void clearNotification();
+    void postNotification();
+
+    // Called from the owner thread only.
+    bool hasReadData() const;
+    qint64 bytesAvailable() const { return readBuffer.size(); }
+    qint64 read(char *data, qint64 maxSize);
+    void discardReadData();
+
+    qint64 bytesToWrite() const { return writeBuffer.size(); }
+    qint64 write(const char *data, qint64 maxSize);
+    void discardWriteData();
+    qint64 takeWrittenBytes() { return writtenBytes.exchange(0); }
+    int takeWriteError() { return writeError.exchange(0); }
+
+protected:
+    void run() override;
+
+private:
+    void wakeUp();
+    bool readFromPort(bool hungUp);
+    bool writeToPort();
+    bool failWrite(int error);
+
+    QSerialPortSpscBuffer readBuffer;
+    QSerialPortSpscBuffer writeBuffer;
+    const int descriptor;
+    const bool readable;
+    int wakeUpPipe[2] = { -1, -1 };
+    int notificationPipe[2] = { -1, -1 };
+
+    std::atomic<bool> stopRequested{false};
+    std::atomic<bool> notificationPending{false};
+    std::atomic<qint64> writtenBytes{0};
+    // Set by the owner thread, and reset by the I/O thread once it has
+    // dropped the data, as only the consumer may free the ring buffer.
+    std::atomic<bool> writeDiscardRequested{false};
+    std::atomic<int> writeError{0};
+    // Set once reading has stopped, with the errno of the failed read,
+    // or 0 at the end of the data.
+    std::atomic<bool> readFinished{false};
+    std::atomic<int> readError{0};
+    // Published by the I/O thread before it polls without waiting for
+    // the port to be writable, or readable, respectively.
+    std::atomic<bool> waitingForWriteData{false};
+    std::atomic<bool> waitingForReadSpace{false};
+};
+
+QT_END_NAMESPACE
+
+#endif // QSERIALPORTIOTHREAD_P_H
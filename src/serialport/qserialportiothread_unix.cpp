@@ -0,0 +1,349 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qserialportiothread_p.h"
+
+#include <QtCore/qdeadlinetimer.h>
+#include <QtCore/qmath.h>
+
+#include <private/qcore_unix_p.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+QT_BEGIN_NAMESPACE
+
+static inline quintptr qt_ring_capacity(qint64 capacity)
+{
+    // The next power of two which is not smaller than the capacity.
+    return quintptr(qNextPowerOfTwo(quint64(qMax(capacity, qint64(2)) - 1)));
+}
+
+QSerialPortSpscBuffer::QSerialPortSpscBuffer(qint64 capacity)
+    : data(new char[qt_ring_capacity(capacity)])
+    , mask(qt_ring_capacity(capacity) - 1)
+{
+}
+
+char *QSerialPortSpscBuffer::writePointer(qint64 *maxSize) const
+{
+    const quintptr position = tail.load(std::memory_order_relaxed);
+    const quintptr used = position - head.load(std::memory_order_acquire);
+    const quintptr offset = position & mask;
+    *maxSize = qint64(qMin(mask + 1 - used, mask + 1 - offset));
+    return data.get() + offset;
+}
+
+void QSerialPortSpscBuffer::commit(qint64 bytes)
+{
+    tail.store(tail.load(std::memory_order_relaxed) + quintptr(bytes), std::memory_order_release);
+}
+
+qint64 QSerialPortSpscBuffer::write(const char *data, qint64 maxSize)
+{
+    qint64 written = 0;
+    while (written < maxSize) {
+        qint64 blockSize = 0;
+        char *ptr = writePointer(&blockSize);
+        blockSize = qMin(blockSize, maxSize - written);
+        if (blockSize <= 0)
+            break;
+        ::memcpy(ptr, data + written, size_t(blockSize));
+        commit(blockSize);
+        written += blockSize;
+    }
+    return written;
+}
+
+const char *QSerialPortSpscBuffer::readPointer(qint64 *maxSize) const
+{
+    const quintptr position = head.load(std::memory_order_relaxed);
+    const quintptr used = tail.load(std::memory_order_acquire) - position;
+    const quintptr offset = position & mask;
+    *maxSize = qint64(qMin(used, mask + 1 - offset));
+    return data.get() + offset;
+}
+
+void QSerialPortSpscBuffer::free(qint64 bytes)
+{
+    head.store(head.load(std::memory_order_relaxed) + quintptr(bytes), std::memory_order_release);
+}
+
+qint64 QSerialPortSpscBuffer::read(char *data, qint64 maxSize)
+{
+    qint64 readBytes = 0;
+    while (readBytes < maxSize) {
+        qint64 blockSize = 0;
+        const char *ptr = readPointer(&blockSize);
+        blockSize = qMin(blockSize, maxSize - readBytes);
+        if (blockSize <= 0)
+            break;
+        ::memcpy(data + readBytes, ptr, size_t(blockSize));
+        free(blockSize);
+        readBytes += blockSize;
+    }
+    return readBytes;
+}
+
+QSerialPortIoThread::QSerialPortIoThread(int descriptor, bool readable, qint64 bufferSize)
+    : readBuffer(readable ? bufferSize : 0)
+    , writeBuffer(bufferSize)
+    , descriptor(descriptor)
+    , readable(readable)
+{
+    setObjectName(QStringLiteral("QSerialPortIoThread"));
+}
+
+QSerialPortIoThread::~QSerialPortIoThread()
+{
+    stop();
+
+    for (int fd : { wakeUpPipe[0], wakeUpPipe[1], notificationPipe[0], notificationPipe[1] }) {
+        if (fd != -1)
+            qt_safe_close(fd);
+    }
+}
+
+bool QSerialPortIoThread::initialize()
+{
+    return qt_safe_pipe(wakeUpPipe, O_NONBLOCK) == 0
+            && qt_safe_pipe(notificationPipe, O_NONBLOCK) == 0;
+}
+
+void QSerialPortIoThread::stop()
+{
+    if (!isRunning())
+        return;
+
+    stopRequested.store(true);
+    wakeUp();
+    wait();
+}
+
+// The pipe is drained before the pending flag is reset, so that a
+// notification posted in between is not lost: the data it is about
+// has already been published, and is handled by the caller.
+void QSerialPortIoThread::clearNotification()
+{
+    char buffer[16];
+    while (qt_safe_read(notificationPipe[0], buffer, sizeof(buffer)) > 0) {
+    }
+    notificationPending.store(false);
+}
+
+void QSerialPortIoThread::postNotification()
+{
+    if (!notificationPending.exchange(true)) {
+        const char c = 0;
+        qt_safe_write(notificationPipe[1], &c, 1);
+    }
+}
+
+bool QSerialPortIoThread::hasReadData() const
+{
+    return !readBuffer.isEmpty() || readFinished.load(std::memory_order_acquire);
+}
+
+// Behaves like reading from the non-blocking descriptor itself.
+qint64 QSerialPortIoThread::read(char *data, qint64 maxSize)
+{
+    // Seen before the data is taken, so that no data is left behind.
+    const bool finished = readFinished.load(std::memory_order_acquire);
+    const qint64 readBytes = readBuffer.read(data, maxSize);
+
+    // The I/O thread does not poll the port while it has no space left.
+    if (readBytes > 0) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waitingForReadSpace.load(std::memory_order_relaxed))
+            wakeUp();
+    }
+
+    if (readBytes > 0)
+        return readBytes;
+    if (!finished) {
+        errno = EAGAIN;
+        return -1;
+    }
+    if (const int error = readError.load()) {
+        errno = error;
+        return -1;
+    }
+    return 0;
+}
+
+void QSerialPortIoThread::discardReadData()
+{
+    readBuffer.free(readBuffer.size());
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waitingForReadSpace.load(std::memory_order_relaxed))
+        wakeUp();
+}
+
+qint64 QSerialPortIoThread::write(const char *data, qint64 maxSize)
+{
+    // The I/O thread does not poll the port while it has nothing to write.
+    // Whether the ring buffer was empty before tells nothing, as the I/O
+    // thread may have drained it in the meantime, so the flag published
+    // by the I/O thread is checked after the data.
+    const qint64 written = writeBuffer.write(data, maxSize);
+    if (written > 0) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waitingForWriteData.load(std::memory_order_relaxed))
+            wakeUp();
+    }
+    return written;
+}
+
+// Returns once the I/O thread has dropped the data, so that none of it
+// is written afterwards.
+void QSerialPortIoThread::discardWriteData()
+{
+    if (writeBuffer.isEmpty())
+        return;
+
+    writeDiscardRequested.store(true);
+    wakeUp();
+    while (writeDiscardRequested.load() && !isFinished())
+        QThread::yieldCurrentThread();
+
+    // Nobody else consumes the data once the thread has finished.
+    if (writeDiscardRequested.exchange(false))
+        writeBuffer.free(writeBuffer.size());
+}
+
+void QSerialPortIoThread::wakeUp()
+{
+    const char c = 0;
+    qt_safe_write(wakeUpPipe[1], &c, 1);
+}
+
+void QSerialPortIoThread::run()
+{
+    pollfd fds[2] = { qt_make_pollfd(wakeUpPipe[0], POLLIN), qt_make_pollfd(descriptor, 0) };
+
+    while (!stopRequested.load()) {
+        const bool reading = readable && !readFinished.load(std::memory_order_relaxed);
+        bool pollRead = reading && !readBuffer.isFull();
+        bool pollWrite = !writeBuffer.isEmpty();
+
+        // Publish what is waited for before checking the buffers again,
+        // so that either the owner thread sees the flag and wakes this
+        // thread up, or the check below sees its data, or its free space.
+        waitingForReadSpace.store(reading && !pollRead, std::memory_order_relaxed);
+        waitingForWriteData.store(!pollWrite, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        pollRead = pollRead || (reading && !readBuffer.isFull());
+        pollWrite = pollWrite || !writeBuffer.isEmpty();
+
+        fds[1].events = 0;
+        if (pollRead)
+            fds[1].events |= POLLIN;
+        if (pollWrite)
+            fds[1].events |= POLLOUT;
+        // Negative descriptors are ignored by poll().
+        fds[1].fd = fds[1].events ? descriptor : -1;
+
+        if (qt_safe_poll(fds, 2, QDeadlineTimer(QDeadlineTimer::Forever)) < 0) {
+            // Nothing is read or written anymore, the owner thread
+            // reports the error.
+            const int error = errno;
+            if (reading) {
+                readError.store(error);
+                readFinished.store(true, std::memory_order_release);
+            }
+            failWrite(error);
+            postNotification();
+            break;
+        }
+
+        waitingForReadSpace.store(false, std::memory_order_relaxed);
+        waitingForWriteData.store(false, std::memory_order_relaxed);
+
+        if (fds[0].revents & POLLIN) {
+            char buffer[16];
+            while (qt_safe_read(wakeUpPipe[0], buffer, sizeof(buffer)) > 0) {
+            }
+        }
+
+        if (writeDiscardRequested.load()) {
+            writeBuffer.free(writeBuffer.size());
+            writeDiscardRequested.store(false);
+            pollWrite = false;
+        }
+
+        bool notify = false;
+        if (fds[1].revents & (POLLIN | POLLHUP | POLLERR | POLLNVAL))
+            notify |= readFromPort(fds[1].revents & POLLHUP);
+        if (fds[1].revents & (POLLOUT | POLLERR | POLLNVAL)) {
+            notify |= writeToPort();
+        } else if (pollWrite && (fds[1].revents & POLLHUP)) {
+            // The peer is gone, poll() would keep reporting the hang-up
+            // without the port ever becoming writable.
+            notify |= failWrite(EIO);
+        }
+        if (notify)
+            postNotification();
+    }
+}
+
+// Reads as much as fits, in up to two parts if the free space wraps around.
+bool QSerialPortIoThread::readFromPort(bool hungUp)
+{
+    if (!readable || readFinished.load(std::memory_order_relaxed))
+        return false;
+
+    bool received = false;
+    for (int part = 0; part < 2; ++part) {
+        qint64 space = 0;
+        char *ptr = readBuffer.writePointer(&space);
+        if (space <= 0)
+            break;
+
+        const qint64 readBytes = qt_safe_read(descriptor, ptr, space);
+        if (readBytes <= 0) {
+            // Nothing is left to read, but only stop once the peer is gone.
+            if (readBytes < 0 ? (errno == EAGAIN || errno == EWOULDBLOCK) : !hungUp)
+                break;
+            readError.store(readBytes < 0 ? errno : 0);
+            readFinished.store(true, std::memory_order_release);
+            return true;
+        }
+
+        readBuffer.commit(readBytes);
+        received = true;
+        if (readBytes < space)
+            break;
+    }
+    return received;
+}
+
+bool QSerialPortIoThread::writeToPort()
+{
+    qint64 size = 0;
+    const char *ptr = writeBuffer.readPointer(&size);
+    if (size <= 0)
+        return false;
+
+    const qint64 written = qt_safe_write(descriptor, ptr, size);
+    if (written < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+            return false;
+        return failWrite(errno);
+    }
+
+    writeBuffer.free(written);
+    writtenBytes.fetch_add(written);
+    return written > 0;
+}
+
+// Nothing more is written, the owner thread reports the error.
+bool QSerialPortIoThread::failWrite(int error)
+{
+    writeError.store(error);
+    writeBuffer.free(writeBuffer.size());
+    return true;
+}
+
+QT_END_NAMESPACE
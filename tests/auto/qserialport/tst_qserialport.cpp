@@ -5,6 +5,7 @@
 #include <QtTest/private/qpropertytesthelper_p.h>
 #include <QtSerialPort/QSerialPort>
 #include <QtSerialPort/QSerialPortInfo>
+#include <QtSerialPort/private/qserialport_p.h>
 
 #include <QThread>
 
@@ -14,6 +15,7 @@ Q_DECLARE_METATYPE(QSerialPort::DataBits);
 Q_DECLARE_METATYPE(QSerialPort::Parity);
 Q_DECLARE_METATYPE(QSerialPort::StopBits);
 Q_DECLARE_METATYPE(QSerialPort::FlowControl);
+Q_DECLARE_METATYPE(QSerialPort::FramingProtocol);
 Q_DECLARE_METATYPE(QIODevice::OpenMode);
 Q_DECLARE_METATYPE(QIODevice::OpenModeFlag);
 Q_DECLARE_METATYPE(Qt::ConnectionType);
@@ -96,6 +98,38 @@ private slots:
     void asynchronousWriteByTimer();
 
     void asyncReadWithLimitedReadBufferSize();
+    void readChunkSize();
+    void adaptiveReadChunkSize();
+    void readDrainBudget();
+    void readView();
+    void readyReadThreshold();
+    void readyReadThresholdWithPartialReads();
+    void readyReadLatency();
+    void minimumReadSize();
+    void readFrame();
+    void readDecodedFrame_data();
+    void readDecodedFrame();
+    void writeFrame_data();
+    void writeFrame();
+    void readWithTimestamps();
+    void readBufferWatermarks();
+    void inputThrottling();
+    void discardOldestData_data();
+    void discardOldestData();
+    void preallocatedReadBuffer();
+    void kernelBytesAvailable();
+    void writeSeveralBufferBlocks();
+    void immediateWrite();
+    void writeSharedPayload_data();
+    void writeSharedPayload();
+    void writeCoalescing();
+    void writeUrgent();
+    void transmitComplete();
+    void rs485Settings();
+    void writeAddressed();
+    void receiveErrorMarking();
+    void ioThread();
+    void ioThreadSmallWrites();
 
     void readBufferOverflow();
     void readAfterInputClear();
@@ -960,6 +994,963 @@ void tst_QSerialPort::asyncReadWithLimitedReadBufferSize()
     QVERIFY2(!timeout(), "Timed out when waiting for the read or write.");
 }
 
+void tst_QSerialPort::readChunkSize()
+{
+    QSerialPort senderPort(m_senderPortName);
+    QVERIFY(senderPort.open(QSerialPort::WriteOnly));
+
+    QSerialPort receiverPort(m_receiverPortName);
+    QVERIFY(receiverPort.readChunkSize() > 0);
+    receiverPort.setReadChunkSize(4);
+    QCOMPARE(receiverPort.readChunkSize(), qint64(4));
+    QVERIFY(receiverPort.open(QSerialPort::ReadOnly));
+
+    AsyncReader2 reader(receiverPort, alphabetArray);
+
+    QCOMPARE(senderPort.write(alphabetArray), qint64(alphabetArray.size()));
+
+    enterLoop(1);
+    QVERIFY2(!timeout(), "Timed out when waiting for the read or write.");
+}
+
+void tst_QSerialPort::adaptiveReadChunkSize()
+{
+    QSerialPort senderPort(m_senderPortName);
+    QVERIFY(senderPort.open(QSerialPort::WriteOnly));
+
+    QSerialPort receiverPort(m_receiverPortName);
+    QCOMPARE(receiverPort.isAdaptiveReadChunkSizeEnabled(), false);
+    receiverPort.setAdaptiveReadChunkSizeEnabled(true);
+    QCOMPARE(receiverPort.isAdaptiveReadChunkSizeEnabled(), true);
+    QVERIFY(receiverPort.open(QSerialPort::ReadOnly));
+
+    {
+        const QByteArray data = alphabetArray.repeated(64);
+        AsyncReader2 reader(receiverPort, data);
+
+        QCOMPARE(senderPort.write(data), qint64(data.size()));
+
+        enterLoop(5);
+        QVERIFY2(!timeout(), "Timed out when waiting for the read or write.");
+    }
+
+    // A backlog in the driver which fills the chunk makes it grow, even
+    // though the reads only request what is queued.
+    const auto d = static_cast<QSerialPortPrivate *>(QObjectPrivate::get(&receiverPort));
+    receiverPort.setAdaptiveReadChunkSizeEnabled(true);
+    const qint64 initialChunkSize = d->currentReadChunkSize;
+
+    const QByteArray backlog = alphabetArray.repeated(32);
+    QCOMPARE(senderPort.write(backlog), qint64(backlog.size()));
+    QVERIFY2(senderPort.waitForBytesWritten(500), "Waiting for bytes written failed");
+
+    // Without the event loop, the data is left in the driver.
+    QDeadlineTimer deadline(5000);
+    while (receiverPort.kernelBytesAvailable() < backlog.size() && !deadline.hasExpired())
+        QThread::msleep(10);
+
+    QTRY_COMPARE(receiverPort.bytesAvailable(), qint64(backlog.size()));
+    QCOMPARE(receiverPort.readAll(), backlog);
+    QVERIFY(d->currentReadChunkSize > initialChunkSize);
+}
+
+void tst_QSerialPort::readDrainBudget()
+{
+    QSerialPort senderPort(m_senderPortName);
+    QVERIFY(senderPort.open(QSerialPort::WriteOnly));
+
+    QSerialPort receiverPort(m_receiverPortName);
+    QCOMPARE(receiverPort.readDrainBudget(), qint64(0));
+    receiverPort.setReadChunkSize(8);
+    receiverPort.setReadDrainBudget(1024);
+    QCOMPARE(receiverPort.readDrainBudget(), qint64(1024));
+    QVERIFY(receiverPort.open(QSerialPort::ReadOnly));
+
+    const QByteArray data = alphabetArray.repeated(16);
+    AsyncReader2 reader(receiverPort, data);
+
+    QCOMPARE(senderPort.write(data), qint64(data.size()));
+
+    enterLoop(5);
+    QVERIFY2(!timeout(), "Timed out when waiting for the read or write.");
+}
+
+void tst_QSerialPort::readView()
+{
+    QSerialPort senderPort(m_senderPortName);
+    QVERIFY(senderPort.open(QSerialPort::WriteOnly));
+
+    QSerialPort receiverPort(m_receiverPortName);
+    QVERIFY(receiverPort.readView().isEmpty());
+    QVERIFY(receiverPort.open(QSerialPort::ReadOnly));
+
+    QCOMPARE(senderPort.write(alphabetArray), qint64(alphabetArray.size()));
+    QVERIFY2(senderPort.waitForBytesWritten(100), "Waiting for bytes written failed");
+
+    while (receiverPort.bytesAvailable() < alphabetArray.size()
+           && receiverPort.waitForReadyRead(100)) {
+    }
+
+    QByteArray viewed;
+    for (qint64 offset = 0; offset < receiverPort.bytesAvailable();) {
+        const QByteArrayView view = receiverPort.readView(offset);
+        QVERIFY(!view.isEmpty());
+        viewed.append(view);
+        offset += view.size();
+    }
+    QCOMPARE(viewed, alphabetArray);
+    QVERIFY(receiverPort.readView(alphabetArray.size()).isEmpty());
+
+    // Viewing does not consume the data
+    QCOMPARE(receiverPort.bytesAvailable(), qint64(alphabetArray.size()));
+
+    QCOMPARE(receiverPort.skip(3), qint64(3));
+    QVERIFY(receiverPort.readView().startsWith(alphabetArray.mid(3, 1)));
+    QCOMPARE(receiverPort.readAll(), alphabetArray.mid(3));
+    QVERIFY(receiverPort.readView().isEmpty());
+}
+
+void tst_QSerialPort::readyReadThreshold()
+{
+    QSerialPort senderPort(m_senderPortName);
+    QVERIFY(senderPort.open(QSerialPort::WriteOnly));
+
+    QSerialPort receiverPort(m_receiverPortName);
+    QCOMPARE(receiverPort.readyReadThreshold(), qint64(0));
+    receiverPort.setReadyReadThreshold(alphabetArray.size());
+    QCOMPARE(receiverPort.readyReadThreshold(), qint64(alphabetArray.size()));
+    QVERIFY(receiverPort.open(QSerialPort::ReadOnly));
+
+    qint64 bytesAvailableOnReadyRead = 0;
+    connect(&receiverPort, &QSerialPort::readyRead, this, [&]() {
+        bytesAvailableOnReadyRead = receiverPort.bytesAvailable();
+        tst_QSerialPort::exitLoop();
+    });
+
+    // Send the data byte by byte, so that it arrives in several pieces
+    AsyncWriterByTimer writer(senderPort, Qt::DirectConnection, alphabetArray);
+
+    enterLoop(1);
+    QVERIFY2(!timeout(), "Timed out when waiting for the read or write.");
+    QVERIFY(bytesAvailableOnReadyRead >= alphabetArray.size());
+    QCOMPARE(receiverPort.readAll(), alphabetArray);
+}
+
+void tst_QSerialPort::readyReadThresholdWithPartialReads()
+{
+    QSerialPort senderPort(m_senderPortName);
+    QVERIFY(senderPort.open(QSerialPort::WriteOnly));
+
+    QSerialPort receiverPort(m_receiverPortName);
+    receiverPort.setReadyReadThreshold(4);
+    QVERIFY(receiverPort.open(QSerialPort::ReadOnly));
+
+    // The data left in the buffer must not trigger readyRead() again
+    int readyReadCount = 0;
+    QByteArray readData;
+    connect(&receiverPort, &QSerialPort::readyRead, this, [&]() {
+        ++readyReadCount;
+        readData += receiverPort.read(1);
+    });
+
+    AsyncWriterByTimer writer(senderPort, Qt::DirectConnection, alphabetArray);
+
+    QTRY_COMPARE(readData.size() + receiverPort.bytesAvailable(), qint64(alphabetArray.size()));
+    QVERIFY(readyReadCount > 0);
+    QVERIFY(readyReadCount <= alphabetArray.size() / 4);
+    QCOMPARE(readData + receiverPort.readAll(), alphabetArray);
+}
+
+void tst_QSerialPort::readyReadLatency()
+{
+    using namespace std::chrono_literals;
+
+    QSerialPort senderPort(m_senderPortName);
+    QVERIFY(senderPort.open(QSerialPort::WriteOnly));
+
+    QSerialPort receiverPort(m_receiverPortName);
+    QCOMPARE(receiverPort.readyReadLatency(), 0us);
+    receiverPort.setReadyReadThreshold(alphabetArray.size() * 2);
+    receiverPort.setReadyReadLatency(20ms);
+    QCOMPARE(receiverPort.readyReadLatency(), 20000us);
+    QVERIFY(receiverPort.open(QSerialPort::ReadOnly));
+
+    AsyncReader2 reader(receiverPort, alphabetArray);
+
+    // The threshold is never reached, so the latency has to trigger readyRead()
+    QCOMPARE(senderPort.write(alphabetArray), qint64(alphabetArray.size()));
+
+    enterLoop(1);
+    QVERIFY2(!timeout(), "Timed out when waiting for the read or write.");
+}
+
+void tst_QSerialPort::minimumReadSize()
+{
+    using namespace std::chrono_literals;
+
+    QSerialPort senderPort(m_senderPortName);
+    QVERIFY(senderPort.open(QSerialPort::WriteOnly));
+
+    QSerialPort receiverPort(m_receiverPortName);
+    QCOMPARE(receiverPort.minimumReadSize(), 0);
+    QVERIFY(!receiverPort.setMinimumReadSize(256));
+    QCOMPARE(receiverPort.error(), QSerialPort::UnsupportedOperationError);
+    QVERIFY(receiverPort.setMinimumReadSize(8));
+    QCOMPARE(receiverPort.minimumReadSize(), 8);
+    receiverPort.setInterByteTimeout(50ms);
+    QCOMPARE(receiverPort.interByteTimeout(), 50ms);
+    QVERIFY(receiverPort.open(QSerialPort::ReadOnly));
+
+    QCOMPARE(senderPort.write(alphabetArray), qint64(alphabetArray.size()));
+    QVERIFY2(senderPort.waitForBytesWritten(100), "Waiting for bytes written failed");
+
+    QByteArray readData;
+    while (readData.size() < alphabetArray.size() && receiverPort.waitForReadyRead(500))
+        readData += receiverPort.readAll();
+    QCOMPARE(readData, alphabetArray);
+
+    // Less than the minimum read size is picked up after the inter-byte timeout
+    QCOMPARE(senderPort.write(newlineArray), qint64(newlineArray.size()));
+    QVERIFY2(senderPort.waitForBytesWritten(100), "Waiting for bytes written failed");
+
+    readData.clear();
+    while (readData.size() < newlineArray.size() && receiverPort.waitForReadyRead(500))
+        readData += receiverPort.readAll();
+    QCOMPARE(readData, newlineArray);
+}
+
+void tst_QSerialPort::readFrame()
+{
+    QSerialPort senderPort(m_senderPortName);
+    QVERIFY(senderPort.open(QSerialPort::WriteOnly));
+
+    QSerialPort receiverPort(m_receiverPortName);
+    QVERIFY(receiverPort.frameDelimiter().isEmpty());
+    receiverPort.setFrameDelimiter("\r\n");
+    QCOMPARE(receiverPort.frameDelimiter(), QByteArray("\r\n"));
+    QVERIFY(receiverPort.open(QSerialPort::ReadOnly));
+    QVERIFY(!receiverPort.canReadFrame());
+
+    QSignalSpy frameReadySpy(&receiverPort, &QSerialPort::frameReady);
+
+    // The second delimiter is split between two writes
+    QCOMPARE(senderPort.write("abc\r\nde\r"), qint64(8));
+    QVERIFY2(senderPort.waitForBytesWritten(100), "Waiting for bytes written failed");
+    QTRY_VERIFY(receiverPort.canReadFrame());
+    QCOMPARE(senderPort.write("\n\r\nfg"), qint64(5));
+    QVERIFY2(senderPort.waitForBytesWritten(100), "Waiting for bytes written failed");
+    QTRY_COMPARE(receiverPort.bytesAvailable(), qint64(13));
+    QVERIFY(frameReadySpy.size() >= 2);
+
+    QCOMPARE(receiverPort.readFrame(), QByteArray("abc"));
+    QCOMPARE(receiverPort.readFrame(), QByteArray("de"));
+    QVERIFY(receiverPort.canReadFrame());
+    QCOMPARE(receiverPort.readFrame(), QByteArray());
+    QVERIFY(!receiverPort.canReadFrame());
+    QCOMPARE(receiverPort.readFrame(), QByteArray());
+    QCOMPARE(receiverPort.readAll(), QByteArray("fg"));
+}
+
+void tst_QSerialPort::readDecodedFrame_data()
+{
+    QTest::addColumn<QSerialPort::FramingProtocol>("protocol");
+    QTest::addColumn<QByteArray>("encoded");
+    QTest::addColumn<QByteArrayList>("frames");
+
+    QTest::newRow("slip")
+            << QSerialPort::SlipFraming
+            << QByteArray("\xC0\x01\xDB\xDC\x02\xC0\xC0\xDB\xDD\xC0", 10)
+            << QByteArrayList{ QByteArray("\x01\xC0\x02"), QByteArray("\xDB") };
+    QTest::newRow("cobs")
+            << QSerialPort::CobsFraming
+            << QByteArray("\x03\x11\x22\x02\x33\x00\x01\x00", 8)
+            << QByteArrayList{ QByteArray("\x11\x22\x00\x33", 4), QByteArray() };
+    QTest::newRow("hdlc")
+            << QSerialPort::HdlcFraming
+            << QByteArray("\x7E\x01\x7D\x5E\x7D\x5D\x7E\x7E\x02\x7E", 10)
+            << QByteArrayList{ QByteArray("\x01\x7E\x7D"), QByteArray("\x02") };
+    QTest::newRow("length-prefix")
+            << QSerialPort::LengthPrefixFraming
+            << QByteArray("\x00\x03" "abc" "\x00\x00" "\x00\x02" "de", 11)
+            << QByteArrayList{ QByteArray("abc"), QByteArray(), QByteArray("de") };
+}
+
+void tst_QSerialPort::readDecodedFrame()
+{
+    QFETCH(QSerialPort::FramingProtocol, protocol);
+    QFETCH(QByteArray, encoded);
+    QFETCH(QByteArrayList, frames);
+
+    QSerialPort senderPort(m_senderPortName);
+    QVERIFY(senderPort.open(QSerialPort::WriteOnly));
+
+    QSerialPort receiverPort(m_receiverPortName);
+    QCOMPARE(receiverPort.framingProtocol(), QSerialPort::NoFraming);
+    QCOMPARE(receiverPort.frameLengthPrefixSize(), 2);
+    QVERIFY(!receiverPort.setFrameLengthPrefixSize(3));
+    receiverPort.setFramingProtocol(protocol);
+    QCOMPARE(receiverPort.framingProtocol(), protocol);
+    QVERIFY(receiverPort.open(QSerialPort::ReadOnly));
+
+    QSignalSpy frameReadySpy(&receiverPort, &QSerialPort::frameReady);
+
+    // Split the data to decode it from more than one chunk
+    const qsizetype half = encoded.size() / 2;
+    QCOMPARE(senderPort.write(encoded.left(half)), qint64(half));
+    QVERIFY2(senderPort.waitForBytesWritten(100), "Waiting for bytes written failed");
+    QTRY_COMPARE(receiverPort.bytesAvailable(), qint64(half));
+    QCOMPARE(senderPort.write(encoded.mid(half)), qint64(encoded.size() - half));
+    QVERIFY2(senderPort.waitForBytesWritten(100), "Waiting for bytes written failed");
+    QTRY_COMPARE(receiverPort.bytesAvailable(), qint64(encoded.size()));
+    QVERIFY(!frameReadySpy.isEmpty());
+
+    for (const QByteArray &frame : std::as_const(frames)) {
+        QVERIFY(receiverPort.canReadFrame());
+        QCOMPARE(receiverPort.readFrame(), frame);
+    }
+    QVERIFY(!receiverPort.canReadFrame());
+    QCOMPARE(receiverPort.bytesAvailable(), qint64(0));
+}
+
+void tst_QSerialPort::writeFrame_data()
+{
+    QTest::addColumn<QSerialPort::FramingProtocol>("protocol");
+
+    QTest::newRow("delimiter") << QSerialPort::NoFraming;
+    QTest::newRow("slip") << QSerialPort::SlipFraming;
+    QTest::newRow("cobs") << QSerialPort::CobsFraming;
+    QTest::newRow("hdlc") << QSerialPort::HdlcFraming;
+    QTest::newRow("length-prefix") << QSerialPort::LengthPrefixFraming;
+}
+
+void tst_QSerialPort::writeFrame()
+{
+    QFETCH(QSerialPort::FramingProtocol, protocol);
+
+    QByteArray payload(600, 'a');
+    for (int i = 0; i < payload.size(); i += 7)
+        payload[i] = char(i);
+
+    QSerialPort senderPort(m_senderPortName);
+    senderPort.setFramingProtocol(protocol);
+    senderPort.setFrameDelimiter("\r\n");
+    QVERIFY(senderPort.open(QSerialPort::WriteOnly));
+
+    QSerialPort receiverPort(m_receiverPortName);
+    receiverPort.setFramingProtocol(protocol);
+    receiverPort.setFrameDelimiter("\r\n");
+    QVERIFY(receiverPort.open(QSerialPort::ReadOnly));
+
+    const QByteArray plainPayload = QByteArray(payload).replace('\n', ' ');
+    const QByteArray &expected = (protocol == QSerialPort::NoFraming) ? plainPayload : payload;
+    QVERIFY(senderPort.writeFrame(expected) >= expected.size());
+    QVERIFY(senderPort.writeFrame(alphabetArray) >= alphabetArray.size());
+    QVERIFY2(senderPort.waitForBytesWritten(500), "Waiting for bytes written failed");
+
+    QTRY_VERIFY(receiverPort.canReadFrame());
+    QCOMPARE(receiverPort.readFrame(), expected);
+    QTRY_VERIFY(receiverPort.canReadFrame());
+    QCOMPARE(receiverPort.readFrame(), alphabetArray);
+}
+
+void tst_QSerialPort::readWithTimestamps()
+{
+    QSerialPort senderPort(m_senderPortName);
+    QVERIFY(senderPort.open(QSerialPort::WriteOnly));
+
+    QSerialPort receiverPort(m_receiverPortName);
+    QVERIFY(!receiverPort.isReceiveTimestampsEnabled());
+    receiverPort.setReceiveTimestampsEnabled(true);
+    QVERIFY(receiverPort.isReceiveTimestampsEnabled());
+    QVERIFY(receiverPort.open(QSerialPort::ReadOnly));
+
+    const auto sendTime = std::chrono::steady_clock::now();
+    QCOMPARE(senderPort.write(alphabetArray), qint64(alphabetArray.size()));
+    QVERIFY2(senderPort.waitForBytesWritten(100), "Waiting for bytes written failed");
+    QTRY_COMPARE(receiverPort.bytesAvailable(), qint64(alphabetArray.size()));
+
+    const auto chunks = receiverPort.readWithTimestamps();
+    QVERIFY(!chunks.isEmpty());
+    QByteArray readData;
+    auto previousTime = sendTime;
+    for (const QSerialPort::ReceivedChunk &chunk : chunks) {
+        QVERIFY(!chunk.data.isEmpty());
+        QVERIFY(chunk.timestamp >= previousTime);
+        QVERIFY(chunk.timestamp <= std::chrono::steady_clock::now());
+        previousTime = chunk.timestamp;
+        readData += chunk.data;
+    }
+    QCOMPARE(readData, alphabetArray);
+    QCOMPARE(receiverPort.bytesAvailable(), qint64(0));
+}
+
+void tst_QSerialPort::readBufferWatermarks()
+{
+    using namespace std::chrono_literals;
+
+    QSerialPort senderPort(m_senderPortName);
+    QVERIFY(senderPort.open(QSerialPort::WriteOnly));
+
+    QSerialPort receiverPort(m_receiverPortName);
+    QCOMPARE(receiverPort.readBufferHighWatermark(), qint64(0));
+    QCOMPARE(receiverPort.readBufferLowWatermark(), qint64(0));
+    receiverPort.setReadBufferHighWatermark(8);
+    receiverPort.setReadBufferLowWatermark(8);
+    QCOMPARE(receiverPort.readBufferLowWatermark(), qint64(7));
+    receiverPort.setReadBufferLowWatermark(2);
+    QCOMPARE(receiverPort.readBufferHighWatermark(), qint64(8));
+    QCOMPARE(receiverPort.readBufferLowWatermark(), qint64(2));
+    receiverPort.setReadBufferSize(16);
+    QVERIFY(receiverPort.open(QSerialPort::ReadOnly));
+    QCOMPARE(receiverPort.readPausedTime(), 0ns);
+
+    QSignalSpy highWaterSpy(&receiverPort, &QSerialPort::readBufferHighWater);
+    QSignalSpy lowWaterSpy(&receiverPort, &QSerialPort::readBufferLowWater);
+
+    QCOMPARE(senderPort.write(alphabetArray), qint64(alphabetArray.size()));
+    QVERIFY2(senderPort.waitForBytesWritten(100), "Waiting for bytes written failed");
+
+    // The buffer gets full, so reading pauses until the data is consumed
+    QTRY_COMPARE(highWaterSpy.size(), 1);
+    QTRY_COMPARE(receiverPort.bytesAvailable(), qint64(16));
+    QTest::qWait(50);
+    QVERIFY(receiverPort.readPausedTime() > 0ns);
+    QCOMPARE(lowWaterSpy.size(), 0);
+
+    QCOMPARE(receiverPort.readAll(), alphabetArray.left(16));
+    QCOMPARE(lowWaterSpy.size(), 1);
+
+    QTRY_COMPARE(receiverPort.bytesAvailable(), qint64(alphabetArray.size() - 16));
+    QCOMPARE(highWaterSpy.size(), 2);
+    QCOMPARE(receiverPort.readAll(), alphabetArray.mid(16));
+    QCOMPARE(lowWaterSpy.size(), 2);
+}
+
+void tst_QSerialPort::inputThrottling()
+{
+    QSerialPort senderPort(m_senderPortName);
+    QVERIFY(senderPort.open(QSerialPort::WriteOnly));
+
+    QSerialPort receiverPort(m_receiverPortName);
+    QVERIFY(!receiverPort.isInputThrottlingEnabled());
+    receiverPort.setInputThrottlingEnabled(true);
+    QVERIFY(receiverPort.isInputThrottlingEnabled());
+    receiverPort.setReadBufferHighWatermark(8);
+    QVERIFY(receiverPort.open(QSerialPort::ReadOnly));
+    QVERIFY(receiverPort.setRequestToSend(true));
+    QVERIFY(!receiverPort.isInputThrottled());
+
+    QSignalSpy rtsSpy(&receiverPort, &QSerialPort::requestToSendChanged);
+
+    QCOMPARE(senderPort.write(alphabetArray), qint64(alphabetArray.size()));
+    QVERIFY2(senderPort.waitForBytesWritten(100), "Waiting for bytes written failed");
+
+    QTRY_VERIFY(receiverPort.isInputThrottled());
+    QVERIFY(!receiverPort.isRequestToSend());
+    QCOMPARE(rtsSpy.size(), 1);
+    QCOMPARE(rtsSpy.at(0).at(0).toBool(), false);
+
+    QTRY_COMPARE(receiverPort.bytesAvailable(), qint64(alphabetArray.size()));
+    QCOMPARE(receiverPort.readAll(), alphabetArray);
+    QVERIFY(!receiverPort.isInputThrottled());
+    QVERIFY(receiverPort.isRequestToSend());
+    QCOMPARE(rtsSpy.size(), 2);
+    QCOMPARE(rtsSpy.at(1).at(0).toBool(), true);
+
+    // With hardware flow control, reading stops while throttled, and has
+    // to be resumed however the buffered data is consumed.
+    receiverPort.close();
+    receiverPort.setFlowControl(QSerialPort::HardwareControl);
+    receiverPort.setFrameDelimiter("\n");
+    QVERIFY(receiverPort.open(QSerialPort::ReadOnly));
+
+    QCOMPARE(senderPort.write("aaaa\nbbbb\ncccc\n"), qint64(15));
+    QVERIFY2(senderPort.waitForBytesWritten(100), "Waiting for bytes written failed");
+    QTRY_VERIFY(receiverPort.isInputThrottled());
+
+    // Held back in the driver while throttled.
+    QCOMPARE(senderPort.write("dddd\n"), qint64(5));
+    QVERIFY2(senderPort.waitForBytesWritten(100), "Waiting for bytes written failed");
+
+    QByteArrayList frames;
+    const auto readFrames = [&] {
+        while (receiverPort.canReadFrame())
+            frames.append(receiverPort.readFrame());
+        return frames.size();
+    };
+    QTRY_COMPARE(readFrames(), 4);
+    QCOMPARE(frames, (QByteArrayList{ "aaaa", "bbbb", "cccc", "dddd" }));
+    QVERIFY(!receiverPort.isInputThrottled());
+}
+
+void tst_QSerialPort::discardOldestData_data()
+{
+    QTest::addColumn<QByteArray>("frameDelimiter");
+    QTest::addColumn<QByteArray>("data");
+
+    QTest::newRow("bytes") << QByteArray() << alphabetArray;
+    QTest::newRow("frames") << QByteArray("\n") << QByteArray("aaaa\nbbbb\ncccc\ndddd\n");
+}
+
+void tst_QSerialPort::discardOldestData()
+{
+    QFETCH(QByteArray, frameDelimiter);
+    QFETCH(QByteArray, data);
+
+    QSerialPort senderPort(m_senderPortName);
+    QVERIFY(senderPort.open(QSerialPort::WriteOnly));
+
+    QSerialPort receiverPort(m_receiverPortName);
+    QCOMPARE(receiverPort.readBufferPolicy(), QSerialPort::PauseReading);
+    receiverPort.setReadBufferPolicy(QSerialPort::DiscardOldestData);
+    QCOMPARE(receiverPort.readBufferPolicy(), QSerialPort::DiscardOldestData);
+    receiverPort.setReadBufferSize(10);
+    receiverPort.setFrameDelimiter(frameDelimiter);
+    QVERIFY(receiverPort.open(QSerialPort::ReadOnly));
+
+    QCOMPARE(senderPort.write(data), qint64(data.size()));
+    QVERIFY2(senderPort.waitForBytesWritten(100), "Waiting for bytes written failed");
+
+    QTRY_COMPARE(receiverPort.discardedBytes(), qint64(data.size() - 10));
+    QCOMPARE(receiverPort.bytesAvailable(), qint64(10));
+    QCOMPARE(receiverPort.readAll(), data.right(10));
+}
+
+void tst_QSerialPort::preallocatedReadBuffer()
+{
+    QSerialPort senderPort(m_senderPortName);
+    QVERIFY(senderPort.open(QSerialPort::WriteOnly));
+
+    QSerialPort receiverPort(m_receiverPortName);
+    QVERIFY(!receiverPort.isPreallocatedReadBufferEnabled());
+    receiverPort.setPreallocatedReadBufferEnabled(true);
+    QVERIFY(receiverPort.isPreallocatedReadBufferEnabled());
+    receiverPort.setReadChunkSize(8);
+    QVERIFY(receiverPort.open(QSerialPort::ReadOnly));
+
+    AsyncReader2 reader(receiverPort, alphabetArray);
+    QCOMPARE(senderPort.write(alphabetArray), qint64(alphabetArray.size()));
+
+    enterLoop(1);
+    QVERIFY2(!timeout(), "Timed out when waiting for the read or write.");
+}
+
+void tst_QSerialPort::kernelBytesAvailable()
+{
+    QSerialPort senderPort(m_senderPortName);
+    QCOMPARE(senderPort.kernelBytesToWrite(), qint64(-1));
+    QVERIFY(senderPort.open(QSerialPort::WriteOnly));
+
+    QSerialPort receiverPort(m_receiverPortName);
+    QCOMPARE(receiverPort.kernelBytesAvailable(), qint64(-1));
+    QVERIFY(receiverPort.open(QSerialPort::ReadOnly));
+    QCOMPARE(receiverPort.kernelBytesAvailable(), qint64(0));
+
+    QCOMPARE(senderPort.write(alphabetArray), qint64(alphabetArray.size()));
+    QVERIFY2(senderPort.waitForBytesWritten(100), "Waiting for bytes written failed");
+    QVERIFY(senderPort.kernelBytesToWrite() >= 0);
+
+    // Without an event loop, the data stays queued in the driver
+    for (int i = 0; i < 50 && receiverPort.kernelBytesAvailable() < alphabetArray.size(); ++i)
+        QThread::msleep(10);
+    QCOMPARE(receiverPort.kernelBytesAvailable(), qint64(alphabetArray.size()));
+    QCOMPARE(receiverPort.bytesAvailable(), qint64(0));
+
+    QVERIFY(receiverPort.waitForReadyRead(100));
+    QCOMPARE(receiverPort.kernelBytesAvailable(), qint64(0));
+    QCOMPARE(receiverPort.readAll(), alphabetArray);
+}
+
+void tst_QSerialPort::writeSeveralBufferBlocks()
+{
+    QByteArray data;
+    while (data.size() < 3 * 20000)
+        data += alphabetArray;
+
+    QSerialPort senderPort(m_senderPortName);
+    QVERIFY(senderPort.open(QSerialPort::WriteOnly));
+
+    QSerialPort receiverPort(m_receiverPortName);
+    QVERIFY(receiverPort.open(QSerialPort::ReadOnly));
+
+    qint64 bytesWritten = 0;
+    connect(&senderPort, &QSerialPort::bytesWritten, this, [&bytesWritten](qint64 bytes) {
+        bytesWritten += bytes;
+    });
+
+    // Exceed the chunk size of the write buffer
+    for (qsizetype i = 0; i < data.size(); i += 20000)
+        QCOMPARE(senderPort.write(data.mid(i, 20000)), qint64(data.mid(i, 20000).size()));
+
+    QByteArray readData;
+    QTRY_VERIFY_WITH_TIMEOUT((readData += receiverPort.readAll()).size() >= data.size(), 10000);
+    QCOMPARE(readData, data);
+    QTRY_COMPARE(bytesWritten, qint64(data.size()));
+    QCOMPARE(senderPort.bytesToWrite(), qint64(0));
+}
+
+void tst_QSerialPort::immediateWrite()
+{
+    QSerialPort senderPort(m_senderPortName);
+    QVERIFY(!senderPort.isImmediateWriteEnabled());
+    senderPort.setImmediateWriteEnabled(true);
+    QVERIFY(senderPort.open(QSerialPort::WriteOnly));
+
+    QSerialPort receiverPort(m_receiverPortName);
+    QVERIFY(receiverPort.open(QSerialPort::ReadOnly));
+
+    qint64 bytesWritten = 0;
+    connect(&senderPort, &QSerialPort::bytesWritten, this, [&bytesWritten](qint64 bytes) {
+        bytesWritten += bytes;
+    });
+
+    QCOMPARE(senderPort.write(alphabetArray), qint64(alphabetArray.size()));
+    QCOMPARE(senderPort.write(newlineArray), qint64(newlineArray.size()));
+    // bytesWritten() must not be emitted from within write()
+    QCOMPARE(bytesWritten, qint64(0));
+
+    const QByteArray data = alphabetArray + newlineArray;
+    QByteArray readData;
+    QTRY_VERIFY_WITH_TIMEOUT((readData += receiverPort.readAll()).size() >= data.size(), 1000);
+    QCOMPARE(readData, data);
+    QTRY_COMPARE(bytesWritten, qint64(data.size()));
+    QCOMPARE(senderPort.bytesToWrite(), qint64(0));
+
+    QCOMPARE(senderPort.write(alphabetArray), qint64(alphabetArray.size()));
+    QVERIFY(senderPort.waitForBytesWritten(500));
+}
+
+void tst_QSerialPort::writeSharedPayload_data()
+{
+    QTest::addColumn<bool>("immediateWrite");
+
+    QTest::newRow("buffered") << false;
+    QTest::newRow("immediate") << true;
+}
+
+void tst_QSerialPort::writeSharedPayload()
+{
+    QFETCH(bool, immediateWrite);
+
+    QByteArray payload;
+    while (payload.size() < 100000)
+        payload += alphabetArray;
+    const QByteArray data = payload;
+
+    QSerialPort senderPort(m_senderPortName);
+    senderPort.setImmediateWriteEnabled(immediateWrite);
+    QVERIFY(senderPort.open(QSerialPort::WriteOnly));
+
+    QSerialPort receiverPort(m_receiverPortName);
+    QVERIFY(receiverPort.open(QSerialPort::ReadOnly));
+
+    QCOMPARE(senderPort.write(payload), qint64(payload.size()));
+    if (!immediateWrite) {
+        // The write buffer shares the payload instead of copying it
+        QVERIFY(!payload.isDetached());
+        QCOMPARE(senderPort.bytesToWrite(), qint64(payload.size()));
+    }
+
+    // Modifying the payload must not affect the transmitted data
+    payload.fill('x');
+
+    QByteArray readData;
+    QTRY_VERIFY_WITH_TIMEOUT((readData += receiverPort.readAll()).size() >= data.size(), 20000);
+    QCOMPARE(readData, data);
+    QTRY_COMPARE(senderPort.bytesToWrite(), qint64(0));
+}
+
+void tst_QSerialPort::writeCoalescing()
+{
+    QSerialPort senderPort(m_senderPortName);
+    QCOMPARE(senderPort.writeCoalescingDelay(), std::chrono::microseconds::zero());
+    senderPort.setWriteCoalescingDelay(std::chrono::seconds(10));
+    senderPort.setWriteCoalescingSize(alphabetArray.size());
+    QVERIFY(senderPort.open(QSerialPort::WriteOnly));
+
+    QSerialPort receiverPort(m_receiverPortName);
+    QVERIFY(receiverPort.open(QSerialPort::ReadOnly));
+
+    // The data is held back while the window is open
+    for (int i = 0; i < alphabetArray.size() - 1; ++i) {
+        QCOMPARE(senderPort.write(alphabetArray.mid(i, 1)), qint64(1));
+        QCoreApplication::processEvents();
+    }
+    QCOMPARE(senderPort.bytesToWrite(), qint64(alphabetArray.size() - 1));
+
+    // Reaching the size closes the window early
+    QCOMPARE(senderPort.write(alphabetArray.right(1)), qint64(1));
+    QByteArray readData;
+    QTRY_VERIFY_WITH_TIMEOUT((readData += receiverPort.readAll()).size() >= alphabetArray.size(), 1000);
+    QCOMPARE(readData, alphabetArray);
+    QCOMPARE(senderPort.coalescedWrites(), qint64(alphabetArray.size() - 1));
+
+    // flush() bypasses the window
+    QCOMPARE(senderPort.write(newlineArray), qint64(newlineArray.size()));
+    QVERIFY(senderPort.flush());
+    readData.clear();
+    QTRY_VERIFY_WITH_TIMEOUT((readData += receiverPort.readAll()).size() >= newlineArray.size(), 1000);
+    QCOMPARE(readData, newlineArray);
+}
+
+void tst_QSerialPort::writeUrgent()
+{
+    static const QByteArray urgentArray("!STOP!");
+
+    QSerialPort senderPort(m_senderPortName);
+    QVERIFY(senderPort.open(QSerialPort::WriteOnly));
+
+    QSerialPort receiverPort(m_receiverPortName);
+    QVERIFY(receiverPort.open(QSerialPort::ReadOnly));
+
+    qint64 bytesWritten = 0;
+    connect(&senderPort, &QSerialPort::bytesWritten, this, [&bytesWritten](qint64 bytes) {
+        bytesWritten += bytes;
+    });
+
+    // More bulk data than the driver can take at once
+    const int bulkWrites = 10000;
+    for (int i = 0; i < bulkWrites; ++i)
+        QCOMPARE(senderPort.write(alphabetArray), qint64(alphabetArray.size()));
+    QCOMPARE(senderPort.writeUrgent(urgentArray), qint64(urgentArray.size()));
+    const qint64 totalSize = bulkWrites * alphabetArray.size() + urgentArray.size();
+    QCOMPARE(senderPort.bytesToWrite(), totalSize);
+
+    QByteArray readData;
+    QTRY_VERIFY_WITH_TIMEOUT((readData += receiverPort.readAll()).size() >= totalSize, 20000);
+
+    // The urgent data overtook the bulk data, but did not split any write
+    const qsizetype urgentPosition = readData.indexOf(urgentArray);
+    QVERIFY(urgentPosition < readData.size() - urgentArray.size());
+    QCOMPARE(urgentPosition % alphabetArray.size(), 0);
+    readData.remove(urgentPosition, urgentArray.size());
+    QCOMPARE(readData, alphabetArray.repeated(bulkWrites));
+
+    QTRY_COMPARE(bytesWritten, totalSize);
+    QCOMPARE(senderPort.submittedBytes(QSerialPort::UrgentPriority), qint64(urgentArray.size()));
+    QCOMPARE(senderPort.submittedBytes(QSerialPort::NormalPriority),
+             qint64(bulkWrites * alphabetArray.size()));
+}
+
+void tst_QSerialPort::transmitComplete()
+{
+    QSerialPort senderPort(m_senderPortName);
+    QVERIFY(senderPort.open(QSerialPort::WriteOnly));
+
+    QSerialPort receiverPort(m_receiverPortName);
+    QVERIFY(receiverPort.open(QSerialPort::ReadOnly));
+
+    QList<QByteArray> emitted;
+    connect(&senderPort, &QSerialPort::bytesWritten, this, [&emitted]() {
+        emitted.append("bytesWritten");
+    });
+    connect(&senderPort, &QSerialPort::transmitComplete, this, [&emitted]() {
+        emitted.append("transmitComplete");
+    });
+
+    QCOMPARE(senderPort.write(alphabetArray), qint64(alphabetArray.size()));
+    QTRY_VERIFY(emitted.contains("transmitComplete"));
+    QCOMPARE(emitted.constFirst(), QByteArray("bytesWritten"));
+    QCOMPARE(emitted.constLast(), QByteArray("transmitComplete"));
+    QCOMPARE(emitted.count("transmitComplete"), 1);
+    QCOMPARE(senderPort.kernelBytesToWrite(), qint64(0));
+
+    emitted.clear();
+    QCOMPARE(senderPort.write(newlineArray), qint64(newlineArray.size()));
+    QVERIFY(senderPort.waitForTransmitComplete(1000));
+    QCOMPARE(emitted.constLast(), QByteArray("transmitComplete"));
+    QCOMPARE(senderPort.bytesToWrite(), qint64(0));
+    QCOMPARE(senderPort.kernelBytesToWrite(), qint64(0));
+
+    QByteArray readData;
+    const QByteArray data = alphabetArray + newlineArray;
+    QTRY_VERIFY_WITH_TIMEOUT((readData += receiverPort.readAll()).size() >= data.size(), 1000);
+    QCOMPARE(readData, data);
+}
+
+void tst_QSerialPort::rs485Settings()
+{
+    QSerialPort serialPort(m_senderPortName);
+    QVERIFY(!serialPort.rs485Settings().enabled);
+
+    QSerialPort::Rs485Settings settings;
+    settings.delayBeforeSend = std::chrono::milliseconds(-1);
+    QVERIFY(!serialPort.setRs485Settings(settings));
+    QCOMPARE(serialPort.error(), QSerialPort::UnsupportedOperationError);
+    serialPort.clearError();
+
+    // Disabling the mode does not need any support from the driver
+    settings.delayBeforeSend = std::chrono::milliseconds(1);
+    QVERIFY(serialPort.open(QSerialPort::ReadWrite));
+    QVERIFY(serialPort.setRs485Settings(settings));
+    serialPort.close();
+
+    settings.enabled = true;
+    QVERIFY(serialPort.setRs485Settings(settings));
+    QVERIFY(serialPort.rs485Settings().enabled);
+    QCOMPARE(serialPort.rs485Settings().delayBeforeSend, std::chrono::milliseconds(1));
+
+    // Virtual serial ports usually have no RS-485 support, which has to be
+    // reported cleanly instead of failing in an unspecified way.
+    if (!serialPort.open(QSerialPort::ReadWrite)) {
+        QCOMPARE(serialPort.error(), QSerialPort::UnsupportedOperationError);
+        QVERIFY(!serialPort.isOpen());
+        QSKIP("The serial port driver does not support the RS-485 mode");
+    }
+
+    settings.enabled = false;
+    QVERIFY(serialPort.setRs485Settings(settings));
+    QVERIFY(!serialPort.rs485Settings().enabled);
+}
+
+void tst_QSerialPort::writeAddressed()
+{
+    QSerialPort senderPort(m_senderPortName);
+    QVERIFY(senderPort.open(QSerialPort::WriteOnly));
+
+#if defined(Q_OS_WIN)
+    QCOMPARE(senderPort.writeAddressed(0x42, alphabetArray), qint64(-1));
+    QCOMPARE(senderPort.error(), QSerialPort::UnsupportedOperationError);
+#else
+    // The data bytes of a multidrop bus use space parity
+    QCOMPARE(senderPort.writeAddressed(0x42, alphabetArray), qint64(-1));
+    QCOMPARE(senderPort.error(), QSerialPort::UnsupportedOperationError);
+    senderPort.clearError();
+    QVERIFY(senderPort.setParity(QSerialPort::SpaceParity));
+
+    qint64 bytesWritten = 0;
+    connect(&senderPort, &QSerialPort::bytesWritten, this, [&bytesWritten](qint64 bytes) {
+        bytesWritten += bytes;
+    });
+
+    const qint64 frameSize = alphabetArray.size() + 1;
+    for (quint8 address = 1; address <= 4; ++address)
+        QCOMPARE(senderPort.writeAddressed(address, alphabetArray), frameSize);
+    QCOMPARE(senderPort.bytesToWrite(), 4 * frameSize);
+
+    QTRY_COMPARE(bytesWritten, 4 * frameSize);
+    QCOMPARE(senderPort.error(), QSerialPort::NoError);
+    QCOMPARE(senderPort.parity(), QSerialPort::SpaceParity);
+
+    // Plain writes go out with space parity again
+    QCOMPARE(senderPort.write(alphabetArray), qint64(alphabetArray.size()));
+    QTRY_COMPARE(bytesWritten, 4 * frameSize + alphabetArray.size());
+    QCOMPARE(senderPort.submittedBytes(QSerialPort::NormalPriority),
+             4 * frameSize + alphabetArray.size());
+#endif
+}
+
+void tst_QSerialPort::receiveErrorMarking()
+{
+    QSerialPort senderPort(m_senderPortName);
+    QVERIFY(senderPort.open(QSerialPort::WriteOnly));
+
+    QSerialPort receiverPort(m_receiverPortName);
+    QVERIFY(!receiverPort.isReceiveErrorMarkingEnabled());
+    QVERIFY(receiverPort.open(QSerialPort::ReadOnly));
+
+#if defined(Q_OS_WIN)
+    QVERIFY(!receiverPort.setReceiveErrorMarkingEnabled(true));
+    QCOMPARE(receiverPort.error(), QSerialPort::UnsupportedOperationError);
+#else
+    QVERIFY(receiverPort.setReceiveErrorMarkingEnabled(true));
+    QVERIFY(receiverPort.isReceiveErrorMarkingEnabled());
+
+    // The escaped 0xFF bytes are passed as is
+    const QByteArray data = alphabetArray + QByteArray(3, char(0xFF)) + alphabetArray
+            + QByteArray(1, char(0xFF));
+    QCOMPARE(senderPort.write(data), qint64(data.size()));
+
+    QTRY_VERIFY_WITH_TIMEOUT(receiverPort.bytesAvailable() >= data.size(), 1000);
+    QVERIFY(receiverPort.receiveErrors().isEmpty());
+    QCOMPARE(receiverPort.readAll(), data);
+
+    QVERIFY(receiverPort.setReceiveErrorMarkingEnabled(false));
+    QVERIFY(!receiverPort.isReceiveErrorMarkingEnabled());
+#endif
+}
+
+void tst_QSerialPort::ioThread()
+{
+    QByteArray data;
+    while (data.size() < 100000)
+        data += alphabetArray;
+
+    QSerialPort senderPort(m_senderPortName);
+    QVERIFY(!senderPort.isIoThreadEnabled());
+    senderPort.setIoThreadEnabled(true);
+    QVERIFY(senderPort.isIoThreadEnabled());
+    QVERIFY(senderPort.open(QSerialPort::WriteOnly));
+
+    QSerialPort receiverPort(m_receiverPortName);
+    receiverPort.setIoThreadEnabled(true);
+    QVERIFY(receiverPort.open(QSerialPort::ReadOnly));
+
+    qint64 bytesWritten = 0;
+    connect(&senderPort, &QSerialPort::bytesWritten, this, [&bytesWritten](qint64 bytes) {
+        bytesWritten += bytes;
+    });
+
+    QCOMPARE(senderPort.write(data), qint64(data.size()));
+    QCOMPARE(bytesWritten, qint64(0));
+
+    QByteArray readData;
+    QTRY_VERIFY_WITH_TIMEOUT((readData += receiverPort.readAll()).size() >= data.size(), 5000);
+    QCOMPARE(readData, data);
+    QTRY_COMPARE(bytesWritten, qint64(data.size()));
+    QCOMPARE(senderPort.bytesToWrite(), qint64(0));
+
+    // The blocking API works the same way
+    QCOMPARE(senderPort.write(alphabetArray), qint64(alphabetArray.size()));
+    QVERIFY(senderPort.waitForBytesWritten(500));
+    QVERIFY(receiverPort.waitForReadyRead(500));
+    readData = receiverPort.readAll();
+    while (readData.size() < alphabetArray.size() && receiverPort.waitForReadyRead(500))
+        readData += receiverPort.readAll();
+    QCOMPARE(readData, alphabetArray);
+
+    senderPort.close();
+    receiverPort.close();
+    QVERIFY(receiverPort.open(QSerialPort::ReadOnly));
+    QVERIFY(!receiverPort.waitForReadyRead(50));
+    QCOMPARE(receiverPort.error(), QSerialPort::TimeoutError);
+}
+
+void tst_QSerialPort::ioThreadSmallWrites()
+{
+    QSerialPort senderPort(m_senderPortName);
+    senderPort.setIoThreadEnabled(true);
+    QVERIFY(senderPort.open(QSerialPort::WriteOnly));
+
+    QSerialPort receiverPort(m_receiverPortName);
+    QVERIFY(receiverPort.open(QSerialPort::ReadOnly));
+
+    qint64 bytesWritten = 0;
+    connect(&senderPort, &QSerialPort::bytesWritten, this, [&bytesWritten](qint64 bytes) {
+        bytesWritten += bytes;
+    });
+
+    // Many small writes while the I/O thread is draining the previous ones,
+    // none of them may be left behind in the I/O thread.
+    QByteArray data;
+    QByteArray readData;
+    for (int i = 0; i < 5000; ++i) {
+        const QByteArray chunk = alphabetArray.mid(i % alphabetArray.size(), 1 + i % 3);
+        QCOMPARE(senderPort.write(chunk), qint64(chunk.size()));
+        data += chunk;
+        if (i % 64 == 0) {
+            QCoreApplication::processEvents();
+            readData += receiverPort.readAll();
+        }
+    }
+
+    while (senderPort.bytesToWrite() > 0)
+        QVERIFY(senderPort.waitForBytesWritten(1000));
+    QTRY_VERIFY_WITH_TIMEOUT((readData += receiverPort.readAll()).size() >= data.size(), 5000);
+    QCOMPARE(readData, data);
+    QTRY_COMPARE(bytesWritten, qint64(data.size()));
+}
+
 void tst_QSerialPort::readBufferOverflow()
 {
     QSerialPort senderPort(m_senderPortName);